@@ -0,0 +1,84 @@
+#include "alias_table.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+bool alias_table_build(AliasTable *t, const unsigned *values, const unsigned *weights, unsigned count) {
+    *t = (AliasTable){0};
+
+    uint64_t total = 0;
+    for (unsigned i = 0; i < count; i++) {
+        total += weights[i];
+    }
+    if (count == 0 || total == 0 || total > UINT32_MAX) {
+        fprintf(stderr, "Weighted choice needs 1 to 2^32-1 total weight, got %llu\n",
+                (unsigned long long)total);
+        return false;
+    }
+
+    bool ok = false;
+    // Weights scaled by count, so a column is exactly total tall
+    uint64_t *scaled = malloc(count * sizeof(uint64_t));
+    // Columns still to fill: under-full from the front, over-full from the back
+    unsigned *work = malloc(count * sizeof(unsigned));
+    t->values = malloc(count * sizeof(unsigned));
+    t->aliases = malloc(count * sizeof(unsigned));
+    t->thresholds = malloc(count * sizeof(uint32_t));
+    if (!scaled || !work || !t->values || !t->aliases || !t->thresholds) {
+        fprintf(stderr, "Error in malloc of alias table.\n");
+        goto cleanup;
+    }
+    t->count = count;
+
+    unsigned small_count = 0;
+    unsigned large_start = count;
+    for (unsigned i = 0; i < count; i++) {
+        scaled[i] = (uint64_t)weights[i] * count;
+        t->values[i] = values[i];
+        if (scaled[i] < total) {
+            work[small_count++] = i;
+        } else {
+            work[--large_start] = i;
+        }
+    }
+
+    // Top up each under-full column from an over-full one. Integer weights
+    // keep this exact; only the final 2^32 scaling rounds.
+    while (small_count > 0 && large_start < count) {
+        unsigned small = work[--small_count];
+        unsigned large = work[large_start];
+        t->thresholds[small] = (uint32_t)((scaled[small] << 32) / total);
+        t->aliases[small] = values[large];
+
+        scaled[large] -= total - scaled[small];
+        if (scaled[large] < total) {
+            large_start++;
+            work[small_count++] = large;
+        }
+    }
+
+    // Whatever is left is full: it never takes its alias
+    for (unsigned i = 0; i < small_count; i++) {
+        t->thresholds[work[i]] = UINT32_MAX;
+        t->aliases[work[i]] = values[work[i]];
+    }
+    for (unsigned i = large_start; i < count; i++) {
+        t->thresholds[work[i]] = UINT32_MAX;
+        t->aliases[work[i]] = values[work[i]];
+    }
+    ok = true;
+
+cleanup:
+    free(scaled);
+    free(work);
+    if (!ok) {
+        alias_table_free(t);
+    }
+    return ok;
+}
+
+void alias_table_free(AliasTable *t) {
+    free(t->values);
+    free(t->aliases);
+    free(t->thresholds);
+    *t = (AliasTable){0};
+}
@@ -0,0 +1,28 @@
+#ifndef ALIAS_TABLE_H
+#define ALIAS_TABLE_H
+
+#include "rng.h"
+#include <stdbool.h>
+
+// Weighted choice compiled with Vose's alias method. Each column holds an
+// outcome, the chance of keeping it and the outcome (alias) that fills the
+// rest of the column, so a sample is one 64-bit draw however many outcomes
+// there are: the high half picks the column, the low half the side.
+typedef struct {
+    unsigned count;
+    unsigned *values;           // Outcome kept when the draw is under the threshold
+    unsigned *aliases;          // Outcome taken otherwise
+    uint32_t *thresholds;       // Chance of keeping values[i], out of 2^32
+} AliasTable;
+
+// Weights may be 0 but must not all be; their sum must fit in 32 bits
+bool alias_table_build(AliasTable *t, const unsigned *values, const unsigned *weights, unsigned count);
+void alias_table_free(AliasTable *t);
+
+static inline unsigned alias_table_sample(const AliasTable *t, Rng *rng) {
+    uint64_t draw = rng_next64(rng);
+    uint32_t column = (uint32_t)(((draw >> 32) * t->count) >> 32);
+    return (uint32_t)draw < t->thresholds[column] ? t->values[column] : t->aliases[column];
+}
+
+#endif
@@ -2,20 +2,19 @@
 #include "config.h"
 #include "load_media.h"
 #include "board_click.h"
-
-// Static game configuration - loaded once at startup
-static GameConfig g_config = {0};
-static bool g_config_loaded = false;
+#include "log.h"
+#include <string.h>
 
 bool board_calloc_arrays(struct Board *b);
 void board_free_arrays(struct Board *b);
-unsigned get_entity_sprite_index(unsigned entity_id, TileState tile_state);
-void board_draw_threat_level_text(const struct Board *b, const char *text, int x, int y, SDL_Color color);
+static void board_on_tile_changed(void *context, size_t index);
+static void board_on_entity_transitioned(void *context, size_t index);
+static bool board_load_threat_digits(struct Board *b);
+static void board_create_layer(struct Board *b);
 
-bool board_new(struct Board **board, SDL_Renderer *renderer, unsigned rows,
-               unsigned columns, int scale) {
+bool board_new(struct Board **board, SDL_Renderer *renderer, GameState *state, int scale) {
     // Parameter validation
-    if (!board || !renderer || rows == 0 || columns == 0 || scale <= 0) {
+    if (!board || !renderer || !state || scale <= 0) {
         fprintf(stderr, "Invalid parameters to board_new\n");
         return false;
     }
@@ -28,24 +27,12 @@ bool board_new(struct Board **board, SDL_Renderer *renderer, unsigned rows,
     struct Board *b = *board;
 
     b->renderer = renderer;
-    b->rows = rows;
-    b->columns = columns;
+    b->state = state;
+    b->rows = state->rows;
+    b->columns = state->columns;
     b->scale = scale;
     b->theme = 0;
-
-    // Load game configuration if not already loaded
-    if (!g_config_loaded) {
-#ifdef WASM_BUILD
-        if (!config_load(&g_config, "config_v2.json")) {
-#else
-        if (!config_load(&g_config, "config_v2.json")) {
-#endif
-            fprintf(stderr, "Failed to load game config\n");
-            return false;
-        }
-        g_config_loaded = true;
-        printf("Loaded %u entities from config\n", g_config.entity_count);
-    }
+    rng_seed(&b->tile_rng, state->seed, BOARD_TILE_RNG_STREAM);
 
     // Load entity sprites (dragons theme)
     if (!load_media_sheet(b->renderer, &b->entity_sprites, 
@@ -55,27 +42,32 @@ bool board_new(struct Board **board, SDL_Renderer *renderer, unsigned rows,
         return false;
     }
 
-    // Load tile sprites for TILE_HIDDEN variations
-    if (!load_media_sheet(b->renderer, &b->tile_sprites, 
-                          "images/tile-16x16.png",
-                          PIECE_SIZE, PIECE_SIZE, &b->tile_src_rects)) {
+    // Bake the rotated TILE_HIDDEN variations into one atlas
+    if (!tile_atlas_build(&b->tile_atlas, b->renderer, "images/tile-16x16.png", PIECE_SIZE)) {
         fprintf(stderr, "Failed to load tile sprites\n");
         return false;
     }
 
-    // Load TTF font for threat level display
-    b->threat_font = TTF_OpenFont("images/m6x11.ttf", 12 * b->scale);
-    if (!b->threat_font) {
-        fprintf(stderr, "Failed to load TTF font for threat levels: %s\n", TTF_GetError());
+    board_set_scale(b, b->scale);
+
+    // Load TTF font and digit atlas for threat level display
+    if (!board_load_threat_digits(b)) {
         return false;
     }
 
-    board_set_scale(b, b->scale);
+    // Without a layer board_draw draws the tiles straight to the screen
+    board_create_layer(b);
 
     if (!board_reset(b)) {
         return false;
     }
 
+    state->observer = (GameStateObserver){
+        .context = b,
+        .tile_changed = board_on_tile_changed,
+        .entity_transitioned = board_on_entity_transitioned,
+    };
+
     return true;
 }
 
@@ -86,6 +78,10 @@ void board_free(struct Board **board) {
     
     struct Board *b = *board;
 
+    if (b->state && b->state->observer.context == b) {
+        b->state->observer = (GameStateObserver){0};
+    }
+
     board_free_arrays(b);
 
     if (b->entity_src_rects) {
@@ -98,27 +94,30 @@ void board_free(struct Board **board) {
         b->entity_sprites = NULL;
     }
 
-    if (b->tile_src_rects) {
-        free(b->tile_src_rects);
-        b->tile_src_rects = NULL;
-    }
+    tile_atlas_free(&b->tile_atlas);
 
-    if (b->tile_sprites) {
-        SDL_DestroyTexture(b->tile_sprites);
-        b->tile_sprites = NULL;
-    }
+    digit_atlas_free(&b->threat_digits);
 
     if (b->threat_font) {
         TTF_CloseFont(b->threat_font);
         b->threat_font = NULL;
     }
 
+    if (b->layer) {
+        SDL_DestroyTexture(b->layer);
+        b->layer = NULL;
+    }
+
+    for (int i = 0; i < BOARD_BATCH_COUNT; i++) {
+        render_batch_free(&b->batches[i]);
+    }
+
     b->renderer = NULL;
 
     free(*board);
     *board = NULL;
 
-    printf("board clean.\n");
+    LOG_DEBUG(LOG_CAT_BOARD, "board clean.");
 }
 
 bool board_calloc_arrays(struct Board *b) {
@@ -130,39 +129,41 @@ bool board_calloc_arrays(struct Board *b) {
 
     size_t total_tiles = (size_t)(b->rows * b->columns);
 
-    b->entity_ids = calloc(total_tiles, sizeof(unsigned));
-    if (!b->entity_ids) {
+    b->animations = calloc(total_tiles, sizeof(TileAnimation));
+    if (!b->animations) {
         goto cleanup_failure;
     }
 
-    b->tile_states = calloc(total_tiles, sizeof(TileState));
-    if (!b->tile_states) {
+    b->display_sprites = calloc(total_tiles, sizeof(unsigned));
+    if (!b->display_sprites) {
         goto cleanup_failure;
     }
 
-    b->animations = calloc(total_tiles, sizeof(TileAnimation));
-    if (!b->animations) {
+    b->active_animations = calloc(total_tiles, sizeof(unsigned));
+    if (!b->active_animations) {
         goto cleanup_failure;
     }
+    b->active_count = 0;
 
-    b->display_sprites = calloc(total_tiles, sizeof(unsigned));
-    if (!b->display_sprites) {
+    b->tile_dirty = calloc(total_tiles, sizeof(bool));
+    if (!b->tile_dirty) {
         goto cleanup_failure;
     }
 
-    // Allocate tile variation arrays
-    b->tile_variations = calloc(total_tiles, sizeof(unsigned));
-    if (!b->tile_variations) {
+    b->dirty_tiles = calloc(total_tiles, sizeof(unsigned));
+    if (!b->dirty_tiles) {
         goto cleanup_failure;
     }
+    b->dirty_count = 0;
+    b->layer_stale = true;
 
-    b->tile_rotations = calloc(total_tiles, sizeof(unsigned));
-    if (!b->tile_rotations) {
+    b->hidden_tiles = calloc(total_tiles, sizeof(unsigned));
+    if (!b->hidden_tiles) {
         goto cleanup_failure;
     }
 
-    b->threat_levels = calloc(total_tiles, sizeof(unsigned));
-    if (!b->threat_levels) {
+    b->batched_tiles = calloc(total_tiles, sizeof(Uint8));
+    if (!b->batched_tiles) {
         goto cleanup_failure;
     }
 
@@ -175,14 +176,6 @@ cleanup_failure:
 }
 
 void board_free_arrays(struct Board *b) {
-    if (b->entity_ids) {
-        free(b->entity_ids);
-        b->entity_ids = NULL;
-    }
-    if (b->tile_states) {
-        free(b->tile_states);
-        b->tile_states = NULL;
-    }
     if (b->animations) {
         free(b->animations);
         b->animations = NULL;
@@ -191,18 +184,29 @@ void board_free_arrays(struct Board *b) {
         free(b->display_sprites);
         b->display_sprites = NULL;
     }
-    if (b->tile_variations) {
-        free(b->tile_variations);
-        b->tile_variations = NULL;
+    if (b->active_animations) {
+        free(b->active_animations);
+        b->active_animations = NULL;
+    }
+    b->active_count = 0;
+    if (b->tile_dirty) {
+        free(b->tile_dirty);
+        b->tile_dirty = NULL;
     }
-    if (b->tile_rotations) {
-        free(b->tile_rotations);
-        b->tile_rotations = NULL;
+    if (b->dirty_tiles) {
+        free(b->dirty_tiles);
+        b->dirty_tiles = NULL;
     }
-    if (b->threat_levels) {
-        free(b->threat_levels);
-        b->threat_levels = NULL;
+    b->dirty_count = 0;
+    if (b->hidden_tiles) {
+        free(b->hidden_tiles);
+        b->hidden_tiles = NULL;
     }
+    if (b->batched_tiles) {
+        free(b->batched_tiles);
+        b->batched_tiles = NULL;
+    }
+    b->batches_ready = false;
 }
 
 bool board_reset(struct Board *b) {
@@ -212,59 +216,28 @@ bool board_reset(struct Board *b) {
         return false;
     }
 
-    // Initialize all tiles as hidden with empty entities (entity ID 0)
     size_t total_tiles = (size_t)(b->rows * b->columns);
     for (size_t i = 0; i < total_tiles; i++) {
-        b->entity_ids[i] = 0;        // Empty entity
-        b->tile_states[i] = TILE_HIDDEN;
-        b->animations[i].type = ANIM_NONE;
-        b->display_sprites[i] = SPRITE_HIDDEN;  // Hidden sprite from main.h
-        
-        // Generate random variations for TILE_HIDDEN tiles
-        b->tile_variations[i] = (unsigned)(MIN_TILE_VARIATION + (rand() % (MAX_TILE_VARIATION - MIN_TILE_VARIATION + 1)));
-        b->tile_rotations[i] = (unsigned)(rand() % NUM_TILE_ROTATIONS);          // Random rotation 0-3 (0°, 90°, 180°, 270°)
+        // Random variation and rotation (0°, 90°, 180°, 270°) for TILE_HIDDEN tiles
+        unsigned variation = MIN_TILE_VARIATION + rng_below(&b->tile_rng, TILE_ATLAS_VARIATIONS);
+        unsigned rotation = rng_below(&b->tile_rng, NUM_TILE_ROTATIONS);
+        b->hidden_tiles[i] = tile_atlas_hidden_index(variation, rotation);
     }
 
-    // Calculate initial threat levels
-    board_calculate_threat_levels(b);
+    board_sync_tiles(b);
 
     return true;
 }
 
-bool board_load_solution(struct Board *b, const char *solution_file, unsigned solution_index) {
-    SolutionData solution = {0};
-    
-    if (!config_load_solution(&solution, solution_file, solution_index)) {
-        fprintf(stderr, "Failed to load solution\n");
-        return false;
+void board_sync_tiles(struct Board *b) {
+    size_t cells = (size_t)b->rows * b->columns;
+    for (size_t index = 0; index < cells; index++) {
+        b->animations[index].type = ANIM_NONE;
+        b->display_sprites[index] = get_entity_sprite_index(b->state->config, b->state->entity_ids[index],
+                                                            b->state->tile_states[index]);
     }
-    
-    printf("Loaded solution %u: %s (%ux%u)\n", solution_index, solution.uuid, solution.rows, solution.cols);
-    
-    // Ensure board size matches solution
-    if (solution.rows != b->rows || solution.cols != b->columns) {
-        fprintf(stderr, "Solution size (%ux%u) doesn't match board size (%ux%u)\n",
-                solution.rows, solution.cols, b->rows, b->columns);
-        config_free_solution(&solution);
-        return false;
-    }
-    
-    // Load entity IDs from solution
-    for (unsigned r = 0; r < b->rows; r++) {
-        for (unsigned c = 0; c < b->columns; c++) {
-            unsigned entity_id = solution.board[r][c];
-            board_set_entity_id(b, r, c, entity_id);
-            
-            // All tiles start hidden
-            board_set_tile_state(b, r, c, TILE_HIDDEN);
-        }
-    }
-    
-    // Calculate threat levels for the loaded solution
-    board_calculate_threat_levels(b);
-    
-    config_free_solution(&solution);
-    return true;
+    b->active_count = 0;
+    board_invalidate_layer(b);
 }
 
 void board_set_scale(struct Board *b, int scale) {
@@ -274,401 +247,644 @@ void board_set_scale(struct Board *b, int scale) {
     b->rect.y = GAME_BOARD_Y * b->scale;
     b->rect.w = (int)b->columns * b->piece_size;
     b->rect.h = (int)b->rows * b->piece_size;
+
+    // Re-rasterise the threat digits for the new size once the board has them
+    if (b->threat_font && b->threat_font_scale != scale && !board_load_threat_digits(b)) {
+        fprintf(stderr, "Keeping threat digits at scale %d\n", b->threat_font_scale);
+    }
+
+    if (b->layer) {
+        board_create_layer(b);
+    } else {
+        board_invalidate_layer(b);
+    }
+}
+
+// Opens the threat font at the current scale and renders its digit atlas.
+// The previous font and atlas are only replaced once both succeed.
+static bool board_load_threat_digits(struct Board *b) {
+    TTF_Font *font = TTF_OpenFont("images/m6x11.ttf", 12 * b->scale);
+    if (!font) {
+        fprintf(stderr, "Failed to load TTF font for threat levels: %s\n", TTF_GetError());
+        return false;
+    }
+
+    SDL_Color black = {0, 0, 0, 255};    // Outline color
+    SDL_Color red = {220, 20, 20, 255};  // Main text color
+    DigitAtlas atlas;
+    if (!digit_atlas_build(&atlas, b->renderer, font, red, black)) {
+        TTF_CloseFont(font);
+        return false;
+    }
+
+    digit_atlas_free(&b->threat_digits);
+    if (b->threat_font) {
+        TTF_CloseFont(b->threat_font);
+    }
+    b->threat_font = font;
+    b->threat_font_scale = b->scale;
+    b->threat_digits = atlas;
+    return true;
 }
 
 void board_set_theme(struct Board *b, unsigned theme) { 
     b->theme = theme;
 }
 
-void board_set_size(struct Board *b, unsigned rows, unsigned columns) {
-    board_free_arrays(b);
+bool board_set_size(struct Board *b, unsigned rows, unsigned columns) {
     b->rows = rows;
     b->columns = columns;
     b->rect.w = (int)b->columns * b->piece_size;
     b->rect.h = (int)b->rows * b->piece_size;
+    board_create_layer(b);
+    return board_reset(b);
 }
 
-// Core game state access
-unsigned board_get_entity_id(const struct Board *b, unsigned row, unsigned col) {
-    if (row >= b->rows || col >= b->columns) {
-        return 0; // Return empty entity for out of bounds
+// GameStateObserver callbacks
+static void board_on_tile_changed(void *context, size_t index) {
+    struct Board *b = context;
+    board_mark_tile_dirty(b, index);
+
+    // Update display sprite immediately if not animating
+    if (b->animations[index].type == ANIM_NONE) {
+        b->display_sprites[index] = get_entity_sprite_index(b->state->config, b->state->entity_ids[index],
+                                                            b->state->tile_states[index]);
     }
-    size_t index = (size_t)(row * b->columns + col);
-    return b->entity_ids[index];
 }
 
-void board_set_entity_id(struct Board *b, unsigned row, unsigned col, unsigned entity_id) {
-    if (row >= b->rows || col >= b->columns) {
-        return; // Ignore out of bounds
-    }
-    size_t index = (size_t)(row * b->columns + col);
-    b->entity_ids[index] = entity_id;
-    
-    // Recalculate threat levels since entity change affects neighbors
-    board_calculate_threat_levels(b);
+static void board_on_entity_transitioned(void *context, size_t index) {
+    struct Board *b = context;
+    board_start_animation(b, (unsigned)(index / b->columns), (unsigned)(index % b->columns),
+                          ANIM_ENTITY_TRANSITION, ANIM_TRANSITION_DURATION_MS, false);
 }
 
-TileState board_get_tile_state(const struct Board *b, unsigned row, unsigned col) {
+// Animation system
+
+
+bool board_is_tile_animating(const struct Board *b, unsigned row, unsigned col) {
     if (row >= b->rows || col >= b->columns) {
-        return TILE_HIDDEN; // Return hidden for out of bounds
+        return false;
     }
     size_t index = (size_t)(row * b->columns + col);
-    return b->tile_states[index];
+    return b->animations[index].type != ANIM_NONE;
 }
 
-void board_set_tile_state(struct Board *b, unsigned row, unsigned col, TileState state) {
-    if (row >= b->rows || col >= b->columns) {
-        return; // Ignore out of bounds
-    }
-    size_t index = (size_t)(row * b->columns + col);
-    b->tile_states[index] = state;
-    
-    // Update display sprite immediately if not animating
-    if (b->animations[index].type == ANIM_NONE) {
-        unsigned entity_id = b->entity_ids[index];
-        b->display_sprites[index] = get_entity_sprite_index(entity_id, state);
+bool board_has_animations(const struct Board *b) {
+    return b->active_count > 0;
+}
+
+static Uint32 board_animation_end(const struct Board *b, unsigned index) {
+    const TileAnimation *anim = &b->animations[index];
+    return anim->start_time + anim->duration_ms;
+}
+
+static void board_animation_heap_place(struct Board *b, unsigned slot, unsigned index) {
+    b->active_animations[slot] = index;
+    b->animations[index].active_slot = slot;
+}
+
+// Moves the entry at slot up or down until the heap is ordered again
+static void board_animation_heap_fix(struct Board *b, unsigned slot) {
+    unsigned index = b->active_animations[slot];
+    Uint32 end = board_animation_end(b, index);
+
+    while (slot > 0) {
+        unsigned parent = (slot - 1) / 2;
+        if (board_animation_end(b, b->active_animations[parent]) <= end) {
+            break;
+        }
+        board_animation_heap_place(b, slot, b->active_animations[parent]);
+        slot = parent;
     }
-    
-    // Recalculate threat levels when tile is revealed
-    if (state == TILE_REVEALED) {
-        board_calculate_threat_levels(b);
+
+    for (;;) {
+        unsigned child = 2 * slot + 1;
+        if (child >= b->active_count) {
+            break;
+        }
+        if (child + 1 < b->active_count &&
+            board_animation_end(b, b->active_animations[child + 1]) <
+            board_animation_end(b, b->active_animations[child])) {
+            child++;
+        }
+        if (end <= board_animation_end(b, b->active_animations[child])) {
+            break;
+        }
+        board_animation_heap_place(b, slot, b->active_animations[child]);
+        slot = child;
     }
+
+    board_animation_heap_place(b, slot, index);
 }
 
-// Animation system
+static bool board_animation_is_active(const struct Board *b, size_t index) {
+    unsigned slot = b->animations[index].active_slot;
+    return slot < b->active_count && b->active_animations[slot] == index;
+}
 
+void board_schedule_animation(struct Board *b, size_t index) {
+    if (!board_animation_is_active(b, index)) {
+        board_animation_heap_place(b, b->active_count++, (unsigned)index);
+    }
+    board_animation_heap_fix(b, b->animations[index].active_slot);
+}
 
-bool board_is_tile_animating(const struct Board *b, unsigned row, unsigned col) {
-    if (row >= b->rows || col >= b->columns) {
-        return false;
+void board_cancel_animation(struct Board *b, size_t index) {
+    b->animations[index].type = ANIM_NONE;
+    if (!board_animation_is_active(b, index)) {
+        return;
+    }
+
+    unsigned slot = b->animations[index].active_slot;
+    unsigned last = b->active_animations[--b->active_count];
+    if (slot < b->active_count) {
+        board_animation_heap_place(b, slot, last);
+        board_animation_heap_fix(b, slot);
     }
-    size_t index = (size_t)(row * b->columns + col);
-    return b->animations[index].type != ANIM_NONE;
 }
 
 void board_update_animations(struct Board *b) {
     Uint32 current_time = SDL_GetTicks();
     
-    for (unsigned r = 0; r < b->rows; r++) {
-        for (unsigned c = 0; c < b->columns; c++) {
-            size_t index = (size_t)(r * b->columns + c);
-            TileAnimation *anim = &b->animations[index];
-            
-            if (anim->type != ANIM_NONE) {
-                if (current_time >= anim->start_time + anim->duration_ms) {
-                    // Animation finished
-                    board_finish_animation(b, r, c);
-                } else {
-                    // Update animation progress
-                    float progress = (float)(current_time - anim->start_time) / anim->duration_ms;
-                    
-                    // For now, simple sprite transition (could add interpolation later)
-                    unsigned new_sprite = (progress > 0.5f) ? anim->end_sprite : anim->start_sprite;
-                    if (new_sprite != b->display_sprites[index]) {
-                        printf("  Animation progress %.1f%%: sprite %u -> %u at [%u,%u]\n", 
-                               progress * 100.0f, b->display_sprites[index], new_sprite, r, c);
-                        b->display_sprites[index] = new_sprite;
-                    }
-                }
-            }
+    // Finish everything that is due. board_finish_animation either starts the
+    // next stage, which reschedules the tile, or cancels it.
+    while (b->active_count > 0) {
+        unsigned index = b->active_animations[0];
+        if (current_time < board_animation_end(b, index)) {
+            break;
+        }
+        board_finish_animation(b, index / b->columns, index % b->columns);
+    }
+
+    // Update progress of the animations still running
+    for (unsigned slot = 0; slot < b->active_count; slot++) {
+        unsigned index = b->active_animations[slot];
+        TileAnimation *anim = &b->animations[index];
+        float progress = (float)(current_time - anim->start_time) / anim->duration_ms;
+        
+        // For now, simple sprite transition (could add interpolation later)
+        unsigned new_sprite = (progress > 0.5f) ? anim->end_sprite : anim->start_sprite;
+        if (new_sprite != b->display_sprites[index]) {
+            LOG_DEBUG(LOG_CAT_ANIM, "Animation progress %.1f%%: sprite %u -> %u at [%u,%u]", 
+                                    progress * 100.0f, b->display_sprites[index], new_sprite,
+                                    index / b->columns, index % b->columns);
+            b->display_sprites[index] = new_sprite;
+            board_mark_tile_dirty(b, index);
         }
     }
 }
 
 
 
-unsigned get_entity_sprite_index(unsigned entity_id, TileState tile_state) {
+unsigned get_entity_sprite_index(const GameConfig *config, unsigned entity_id, TileState tile_state) {
     if (tile_state == TILE_HIDDEN) {
         return SPRITE_HIDDEN;
     }
     
-    // For revealed tiles, use entity's sprite position
-    Entity *entity = config_get_entity(&g_config, entity_id);
-    if (entity) {
-        // Convert 2D sprite position to 1D index
-        // Assuming 16 sprites per row in the sprite sheet
-        unsigned sprite_index = entity->sprite_pos.y * 4 + entity->sprite_pos.x;
-        // printf("    Calculating sprite index: y=%u * 4 + x=%u = %u\n", 
-        //        entity->sprite_pos.y, entity->sprite_pos.x, sprite_index);
-        return sprite_index;
+    // For revealed tiles, use entity's precomputed sprite index
+    const EntityLookup *lookup = config_lookup(config, entity_id);
+    if (lookup && lookup->entity) {
+        return lookup->sprite_index;
     }
     
     // Default to cleared sprite if entity not found
-    printf("    Entity %u not found, using SPRITE_CLEARED (%u)\n", entity_id, SPRITE_CLEARED);
+    LOG_WARN(LOG_CAT_BOARD, "Entity %u not found, using SPRITE_CLEARED (%u)", entity_id, SPRITE_CLEARED);
     return SPRITE_CLEARED;
 }
 
-void board_draw(const struct Board *b) {
-    SDL_Rect dest_rect = {0, 0, b->piece_size, b->piece_size};
+static const SDL_Color board_border_color = {100, 100, 100, 255};     // Dark grey
+static const SDL_Color board_background_color = {200, 200, 200, 255}; // Light grey
+static const SDL_Color board_sprite_color = {255, 255, 255, 255};     // No tint
+
+// Draws one tile with its top-left corner at (x, y) of the current target.
+// Revealed tiles draw a border 1 px up/left and 3 px down/right of the tile,
+// over their neighbours.
+static void board_draw_tile(const struct Board *b, size_t index, int x, int y) {
+    SDL_Rect dest_rect = {x, y, b->piece_size, b->piece_size};
     
-    for (unsigned r = 0; r < b->rows; r++) {
-        dest_rect.y = (int)r * b->piece_size + b->rect.y;
-        for (unsigned c = 0; c < b->columns; c++) {
-            dest_rect.x = (int)c * b->piece_size + b->rect.x;
-            
-            size_t index = (size_t)(r * b->columns + c);
-            TileState tile_state = b->tile_states[index];
+    TileState tile_state = b->state->tile_states[index];
+    
+    if (tile_state == TILE_HIDDEN) {
+        // Base tile with its rotated variation, pre-composited in the atlas
+        SDL_RenderCopy(b->renderer, b->tile_atlas.texture,
+                       &b->tile_atlas.hidden[b->hidden_tiles[index]], &dest_rect);
+    } else {
+        // TILE_REVEALED: render dark grey border, light grey background, then entity sprite
+        
+        // Create border rectangle (slightly larger than tile)
+
+        SDL_Rect border_rect = dest_rect;
+        border_rect.x -= 1;
+        border_rect.y -= 1;
+        border_rect.w += 4;
+        border_rect.h += 4;
+        
+        // Render dark grey border
+        SDL_Color border = board_border_color;
+        SDL_SetRenderDrawColor(b->renderer, border.r, border.g, border.b, border.a);
+        SDL_RenderFillRect(b->renderer, &border_rect);
+        
+        // Render light grey background (slightly smaller than border)
+        SDL_Color background = board_background_color;
+        SDL_SetRenderDrawColor(b->renderer, background.r, background.g, background.b, background.a);
+        SDL_RenderFillRect(b->renderer, &dest_rect);
+        
+        // Reset render color to default
+        SDL_SetRenderDrawColor(b->renderer, 0, 0, 0, 255);
+        
+        // Render entity sprite on top or threat level for empty tiles
+        unsigned sprite_index = b->display_sprites[index];
+        unsigned entity_id = b->state->entity_ids[index];
+        
+        // If this is an empty tile (entity_id == 0), render threat level
+        if (entity_id == 0) {
+            unsigned threat_level = b->state->threat_levels[index];
             
-            if (tile_state == TILE_HIDDEN) {
-                // First render the base hidden tile (index 0) - grey tile with light grey border
-                SDL_RenderCopy(b->renderer, b->tile_sprites,
-                               &b->tile_src_rects[0], &dest_rect);
-                
-                // Then render the variation tile (indices 5-7) on top with rotation
-                unsigned tile_variation = b->tile_variations[index];
-                unsigned rotation = b->tile_rotations[index];
-                
-                // Ensure tile variation is valid
-                if (tile_variation < 256) { // Assuming max 256 sprites in tile sheet
-                    // Apply rotation by setting the rotation angle
-                    double angle = rotation * 90.0; // 0°, 90°, 180°, 270°
-                    SDL_Point center = {b->piece_size / 2, b->piece_size / 2};
-                    
-                    SDL_RenderCopyEx(b->renderer, b->tile_sprites,
-                                   &b->tile_src_rects[tile_variation], &dest_rect,
-                                   angle, &center, SDL_FLIP_NONE);
-                }
-            } else {
-                // TILE_REVEALED: render dark grey border, light grey background, then entity sprite
-                
-                // Create border rectangle (slightly larger than tile)
+            // Only render threat level if > 0 (no longer clamped to 0-9)
+            if (threat_level > 0) {
+                // Render the threat level (centered in tile) - red with black outline
+                board_draw_threat_level_centered(b, threat_level, dest_rect);
+            }
+        } else {
+            // Render entity sprite for non-empty tiles
+            // Ensure sprite index is valid
+            if (sprite_index < 256) { // Assuming max 256 sprites in sheet
+                SDL_RenderCopy(b->renderer, b->entity_sprites,
+                               &b->entity_src_rects[sprite_index], &dest_rect);
+            }
+        }
+    }
+}
 
-                SDL_Rect border_rect = dest_rect;
-                border_rect.x -= 1;
-                border_rect.y -= 1;
-                border_rect.w += 4;
-                border_rect.h += 4;
-                
-                // Render dark grey border
-                SDL_SetRenderDrawColor(b->renderer, 100, 100, 100, 255); // Dark grey
-                SDL_RenderFillRect(b->renderer, &border_rect);
-                
-                // Render light grey background (slightly smaller than border)
-                SDL_SetRenderDrawColor(b->renderer, 200, 200, 200, 255); // Light grey
-                SDL_RenderFillRect(b->renderer, &dest_rect);
-                
-                // Reset render color to default
-                SDL_SetRenderDrawColor(b->renderer, 0, 0, 0, 255);
-                
-                // Render entity sprite on top or threat level for empty tiles
-                unsigned sprite_index = b->display_sprites[index];
-                unsigned entity_id = b->entity_ids[index];
-                
-                // If this is an empty tile (entity_id == 0), render threat level
-                if (entity_id == 0) {
-                    unsigned threat_level = b->threat_levels[index];
-                    
-                    // Only render threat level if > 0
-                    if (threat_level > 0) {
-                        // Display the actual threat level (no longer clamped to 0-9)
-                        unsigned display_level = threat_level;
-                        
-                        // Convert to string
-                        char threat_text[16];  // Increased buffer size to handle larger numbers
-                        snprintf(threat_text, sizeof(threat_text), "%u", display_level);
-                        
-                        // Render the threat level text (centered in tile) - red with black outline
-                        board_draw_threat_level_text_centered(b, threat_text, dest_rect);
-                    }
-                } else {
-                    // Render entity sprite for non-empty tiles
-                    // Ensure sprite index is valid
-                    if (sprite_index < 256) { // Assuming max 256 sprites in sheet
-                        SDL_RenderCopy(b->renderer, b->entity_sprites,
-                                       &b->entity_src_rects[sprite_index], &dest_rect);
-                    }
-                }
+// Area a tile paints over: its border when revealed, otherwise the tile
+static SDL_Rect board_tile_footprint(const struct Board *b, size_t index, int x, int y) {
+    if (b->state->tile_states[index] == TILE_HIDDEN) {
+        return (SDL_Rect){x, y, b->piece_size, b->piece_size};
+    }
+    return (SDL_Rect){x - 1, y - 1, b->piece_size + 4, b->piece_size + 4};
+}
+
+// Splits rect minus hole into at most 4 pieces and returns how many
+static int board_rect_subtract(const SDL_Rect *rect, const SDL_Rect *hole, SDL_Rect pieces[4]) {
+    SDL_Rect overlap;
+    if (!SDL_IntersectRect(rect, hole, &overlap)) {
+        pieces[0] = *rect;
+        return 1;
+    }
+
+    int count = 0;
+    int overlap_bottom = overlap.y + overlap.h;
+    int overlap_right = overlap.x + overlap.w;
+    if (overlap.y > rect->y) {
+        pieces[count++] = (SDL_Rect){rect->x, rect->y, rect->w, overlap.y - rect->y};
+    }
+    if (overlap_bottom < rect->y + rect->h) {
+        pieces[count++] = (SDL_Rect){rect->x, overlap_bottom, rect->w, rect->y + rect->h - overlap_bottom};
+    }
+    if (overlap.x > rect->x) {
+        pieces[count++] = (SDL_Rect){rect->x, overlap.y, overlap.x - rect->x, overlap.h};
+    }
+    if (overlap_right < rect->x + rect->w) {
+        pieces[count++] = (SDL_Rect){overlap_right, overlap.y, rect->x + rect->w - overlap_right, overlap.h};
+    }
+    return count;
+}
+
+// Adds the threat digits of tile (row, col) at (x, y). Tiles after it in
+// board order paint over its digits, so the parts under the footprints of
+// the next tile and the three below are left out.
+static bool board_batch_threat_digits(struct Board *b, unsigned row, unsigned col, int x, int y) {
+    size_t index = (size_t)row * b->columns + col;
+    SDL_Rect tile_rect = {x, y, b->piece_size, b->piece_size};
+    unsigned threat_level = b->state->threat_levels[index];
+    int text_x = tile_rect.x + (tile_rect.w - digit_atlas_width(&b->threat_digits, threat_level)) / 2;
+    int text_y = tile_rect.y + (tile_rect.h - b->threat_digits.height) / 2;
+
+    SDL_Rect holes[4];
+    int hole_count = 0;
+    if (col + 1 < b->columns) {
+        holes[hole_count++] = board_tile_footprint(b, index + 1, x + b->piece_size, y);
+    }
+    if (row + 1 < b->rows) {
+        for (unsigned c = col > 0 ? col - 1 : 0; c <= col + 1 && c < b->columns; c++) {
+            int cx = x + ((int)c - (int)col) * b->piece_size;
+            holes[hole_count++] = board_tile_footprint(b, index + b->columns - col + c, cx, y + b->piece_size);
+        }
+    }
+
+    SDL_Rect src[DIGIT_ATLAS_MAX_QUADS];
+    SDL_Rect dst[DIGIT_ATLAS_MAX_QUADS];
+    int quads = digit_atlas_layout(&b->threat_digits, threat_level, text_x, text_y, src, dst);
+    for (int q = 0; q < quads; q++) {
+        // Every hole can split each piece in 4
+        SDL_Rect pieces[256];
+        SDL_Rect split[256];
+        int piece_count = 1;
+        pieces[0] = dst[q];
+        for (int h = 0; h < hole_count; h++) {
+            int split_count = 0;
+            for (int p = 0; p < piece_count; p++) {
+                split_count += board_rect_subtract(&pieces[p], &holes[h], split + split_count);
+            }
+            memcpy(pieces, split, (size_t)split_count * sizeof(SDL_Rect));
+            piece_count = split_count;
+        }
+
+        // Digits are drawn unscaled, so a piece's source is offset like its destination
+        for (int p = 0; p < piece_count; p++) {
+            SDL_Rect piece_src = {
+                src[q].x + pieces[p].x - dst[q].x, src[q].y + pieces[p].y - dst[q].y,
+                pieces[p].w, pieces[p].h
+            };
+            if (!render_batch_add(&b->batches[BOARD_BATCH_DIGITS], &piece_src, &pieces[p], board_sprite_color)) {
+                return false;
             }
         }
     }
+    return true;
 }
 
-// ========== THREAT LEVEL FUNCTIONS ==========
+// What the border, edge and digit batches hold for the tile
+static Uint8 board_batched_flags(const struct Board *b, size_t index) {
+    if (b->state->tile_states[index] == TILE_HIDDEN) {
+        return 0;
+    }
+    if (b->state->entity_ids[index] == 0 && b->state->threat_levels[index] > 0 && b->threat_digits.texture) {
+        return BOARD_BATCHED_REVEALED | BOARD_BATCHED_DIGITS;
+    }
+    return BOARD_BATCHED_REVEALED;
+}
 
-void board_draw_threat_level_text(const struct Board *b, const char *text, int x, int y, SDL_Color color) {
-    if (!b->threat_font || !text) {
+// Sets the tile's slots in the hidden, background and sprite batches, which
+// hold exactly one quad per tile; slots the tile does not use are emptied
+static void board_batch_tile_slots(struct Board *b, size_t index, int x, int y) {
+    SDL_Rect dest_rect = {x, y, b->piece_size, b->piece_size};
+    unsigned slot = (unsigned)index;
+
+    if (b->state->tile_states[index] == TILE_HIDDEN) {
+        render_batch_set(&b->batches[BOARD_BATCH_HIDDEN], slot,
+                         &b->tile_atlas.hidden[b->hidden_tiles[index]], &dest_rect, board_sprite_color);
+        render_batch_set(&b->batches[BOARD_BATCH_BACKGROUNDS], slot, NULL, NULL, board_background_color);
+        render_batch_set(&b->batches[BOARD_BATCH_SPRITES], slot, NULL, NULL, board_sprite_color);
         return;
     }
-    
-    SDL_Surface *text_surface = TTF_RenderText_Solid(b->threat_font, text, color);
-    if (!text_surface) {
-        return;
+
+    unsigned sprite_index = b->display_sprites[index];
+    bool has_sprite = b->state->entity_ids[index] != 0 && sprite_index < 256;
+    render_batch_set(&b->batches[BOARD_BATCH_HIDDEN], slot, NULL, NULL, board_sprite_color);
+    render_batch_set(&b->batches[BOARD_BATCH_BACKGROUNDS], slot, NULL, &dest_rect, board_background_color);
+    render_batch_set(&b->batches[BOARD_BATCH_SPRITES], slot, has_sprite ? &b->entity_src_rects[sprite_index] : NULL,
+                     has_sprite ? &dest_rect : NULL, board_sprite_color);
+}
+
+// Rebuilds the border, edge and digit batches, whose quad count per tile
+// varies
+static bool board_build_outlines(struct Board *b, int origin_x, int origin_y) {
+    render_batch_begin(&b->batches[BOARD_BATCH_BORDERS], NULL);
+    render_batch_begin(&b->batches[BOARD_BATCH_EDGES], NULL);
+    render_batch_begin(&b->batches[BOARD_BATCH_DIGITS], b->threat_digits.texture);
+
+    int size = b->piece_size;
+    bool ok = true;
+    for (unsigned r = 0; r < b->rows && ok; r++) {
+        for (unsigned c = 0; c < b->columns && ok; c++) {
+            size_t index = (size_t)r * b->columns + c;
+            int x = origin_x + (int)c * size;
+            int y = origin_y + (int)r * size;
+            Uint8 flags = board_batched_flags(b, index);
+            b->batched_tiles[index] = flags;
+            if (!(flags & BOARD_BATCHED_REVEALED)) {
+                continue;
+            }
+
+            SDL_Rect border_rect = board_tile_footprint(b, index, x, y);
+            SDL_Rect top_edge = {x - 1, y - 1, size + 4, 1};
+            SDL_Rect left_edge = {x - 1, y, 1, size};
+            ok = render_batch_add(&b->batches[BOARD_BATCH_BORDERS], NULL, &border_rect, board_border_color) &&
+                 (r == 0 || render_batch_add(&b->batches[BOARD_BATCH_EDGES], NULL, &top_edge, board_border_color)) &&
+                 (c == 0 || render_batch_add(&b->batches[BOARD_BATCH_EDGES], NULL, &left_edge, board_border_color)) &&
+                 (!(flags & BOARD_BATCHED_DIGITS) || board_batch_threat_digits(b, r, c, x, y));
+        }
     }
-    
-    SDL_Texture *text_texture = SDL_CreateTextureFromSurface(b->renderer, text_surface);
-    if (!text_texture) {
-        SDL_FreeSurface(text_surface);
-        return;
+    return ok;
+}
+
+// Builds every tile into the batches with the board's top-left at origin.
+// The result matches drawing board_draw_tile in board order: a border is
+// painted over by the tiles after it but lies over the tiles before it, so
+// borders go under all tile content and their parts over earlier tiles are
+// added again on top.
+static bool board_build_batches(struct Board *b, int origin_x, int origin_y) {
+    size_t tiles = (size_t)b->rows * b->columns;
+    render_batch_begin(&b->batches[BOARD_BATCH_HIDDEN], b->tile_atlas.texture);
+    render_batch_begin(&b->batches[BOARD_BATCH_BACKGROUNDS], NULL);
+    render_batch_begin(&b->batches[BOARD_BATCH_SPRITES], b->entity_sprites);
+    bool ok = render_batch_resize(&b->batches[BOARD_BATCH_HIDDEN], (unsigned)tiles) &&
+              render_batch_resize(&b->batches[BOARD_BATCH_BACKGROUNDS], (unsigned)tiles) &&
+              render_batch_resize(&b->batches[BOARD_BATCH_SPRITES], (unsigned)tiles);
+
+    for (size_t index = 0; index < tiles && ok; index++) {
+        board_batch_tile_slots(b, index, origin_x + (int)(index % b->columns) * b->piece_size,
+                               origin_y + (int)(index / b->columns) * b->piece_size);
+    }
+
+    b->batches_ready = ok && board_build_outlines(b, origin_x, origin_y);
+    return b->batches_ready;
+}
+
+// Brings the batches up to date with the dirty tiles. Their slots are
+// patched in place; the outlines are rebuilt only when a tile was revealed
+// or hidden, which moves borders and cuts neighbouring digits, or when it
+// has or had digits, whose threat level may have changed.
+static bool board_patch_batches(struct Board *b, int origin_x, int origin_y) {
+    bool outlines = false;
+    for (unsigned i = 0; i < b->dirty_count; i++) {
+        unsigned index = b->dirty_tiles[i];
+        board_batch_tile_slots(b, index, origin_x + (int)(index % b->columns) * b->piece_size,
+                               origin_y + (int)(index / b->columns) * b->piece_size);
+
+        Uint8 before = b->batched_tiles[index];
+        Uint8 after = board_batched_flags(b, index);
+        if (((before ^ after) & BOARD_BATCHED_REVEALED) || ((before | after) & BOARD_BATCHED_DIGITS)) {
+            outlines = true;
+        }
     }
-    
-    SDL_Rect dest_rect = {
-        x,
-        y,
-        text_surface->w,
-        text_surface->h
-    };
-    
-    SDL_RenderCopy(b->renderer, text_texture, NULL, &dest_rect);
-    
-    SDL_DestroyTexture(text_texture);
-    SDL_FreeSurface(text_surface);
+
+    if (outlines) {
+        b->batches_ready = board_build_outlines(b, origin_x, origin_y);
+    }
+    return b->batches_ready;
 }
 
-void board_draw_threat_level_text_centered(const struct Board *b, const char *text, SDL_Rect tile_rect) {
-    if (!b->threat_font || !text) {
-        return;
+static void board_draw_batches(const struct Board *b) {
+    for (int i = 0; i < BOARD_BATCH_COUNT; i++) {
+        render_batch_draw(&b->batches[i], b->renderer);
     }
-    
-    // Colors for outline effect
-    SDL_Color black = {0, 0, 0, 255};    // Outline color
-    SDL_Color red = {220, 20, 20, 255};  // Main text color
-    
-    // Create text surfaces
-    SDL_Surface *outline_surface = TTF_RenderText_Solid(b->threat_font, text, black);
-    SDL_Surface *main_surface = TTF_RenderText_Solid(b->threat_font, text, red);
-    
-    if (!outline_surface || !main_surface) {
-        if (outline_surface) SDL_FreeSurface(outline_surface);
-        if (main_surface) SDL_FreeSurface(main_surface);
-        return;
+}
+
+// Everything a tile draws stays within half a tile of it: the reveal border
+// reaches 1 px up/left and 3 px down/right, and multi-digit threat levels
+// can be wider than the tile. The layer keeps that margin around the board,
+// so tile (r, c) sits at (margin + c * piece_size, margin + r * piece_size).
+static int board_layer_margin(const struct Board *b) {
+    return b->piece_size / 2;
+}
+
+static void board_create_layer(struct Board *b) {
+    if (b->layer) {
+        SDL_DestroyTexture(b->layer);
+        b->layer = NULL;
     }
-    
-    // Create textures
-    SDL_Texture *outline_texture = SDL_CreateTextureFromSurface(b->renderer, outline_surface);
-    SDL_Texture *main_texture = SDL_CreateTextureFromSurface(b->renderer, main_surface);
-    
-    if (!outline_texture || !main_texture) {
-        if (outline_texture) SDL_DestroyTexture(outline_texture);
-        if (main_texture) SDL_DestroyTexture(main_texture);
-        SDL_FreeSurface(outline_surface);
-        SDL_FreeSurface(main_surface);
+
+    int margin = board_layer_margin(b);
+    int w = b->rect.w + 2 * margin;
+    int h = b->rect.h + 2 * margin;
+    b->layer = SDL_CreateTexture(b->renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_TARGET, w, h);
+    if (!b->layer) {
+        // Oversized boards can exceed the maximum texture size; board_draw
+        // then draws tiles straight to the screen.
+        fprintf(stderr, "Error creating %dx%d board layer: %s\n", w, h, SDL_GetError());
         return;
     }
-    
-    // Calculate centered position within the tile
-    int text_x = tile_rect.x + (tile_rect.w - main_surface->w) / 2;
-    int text_y = tile_rect.y + (tile_rect.h - main_surface->h) / 2;
-    
-    // Outline offset positions (8-directional outline)
-    int outline_offsets[][2] = {
-        {-1, -1}, {0, -1}, {1, -1},  // Top row
-        {-1,  0},          {1,  0},  // Middle row (skip center)
-        {-1,  1}, {0,  1}, {1,  1}   // Bottom row
-    };
-    
-    // Draw black outline in all 8 directions
-    for (int i = 0; i < 8; i++) {
-        SDL_Rect outline_rect = {
-            text_x + outline_offsets[i][0],
-            text_y + outline_offsets[i][1],
-            outline_surface->w,
-            outline_surface->h
-        };
-        SDL_RenderCopy(b->renderer, outline_texture, NULL, &outline_rect);
+    SDL_SetTextureBlendMode(b->layer, SDL_BLENDMODE_BLEND);
+    board_invalidate_layer(b);
+}
+
+void board_invalidate_layer(struct Board *b) {
+    b->layer_stale = true;
+}
+
+void board_mark_tile_dirty(struct Board *b, size_t index) {
+    if (!b->tile_dirty[index]) {
+        b->tile_dirty[index] = true;
+        b->dirty_tiles[b->dirty_count++] = (unsigned)index;
     }
-    
-    // Draw main red text on top
-    SDL_Rect main_rect = {
-        text_x,
-        text_y,
-        main_surface->w,
-        main_surface->h
+}
+
+static void board_draw_all_tiles(const struct Board *b, int origin_x, int origin_y) {
+    for (unsigned r = 0; r < b->rows; r++) {
+        for (unsigned c = 0; c < b->columns; c++) {
+            board_draw_tile(b, (size_t)r * b->columns + c,
+                            origin_x + (int)c * b->piece_size, origin_y + (int)r * b->piece_size);
+        }
+    }
+}
+
+// Redraws the area one tile can cover. Only its 3x3 neighbourhood can draw
+// into that area too, so those tiles are drawn again in board order, clipped
+// to it.
+static void board_redraw_tile(const struct Board *b, unsigned index) {
+    int margin = board_layer_margin(b);
+    unsigned row = index / b->columns;
+    unsigned col = index % b->columns;
+    SDL_Rect area = {
+        (int)col * b->piece_size, (int)row * b->piece_size,
+        b->piece_size + 2 * margin, b->piece_size + 2 * margin
     };
-    SDL_RenderCopy(b->renderer, main_texture, NULL, &main_rect);
-    
-    // Cleanup
-    SDL_DestroyTexture(outline_texture);
-    SDL_DestroyTexture(main_texture);
-    SDL_FreeSurface(outline_surface);
-    SDL_FreeSurface(main_surface);
+
+    SDL_RenderSetClipRect(b->renderer, &area);
+    SDL_SetRenderDrawColor(b->renderer, 0, 0, 0, 0);
+    SDL_RenderFillRect(b->renderer, &area);
+
+    unsigned row_end = row + 1 < b->rows ? row + 1 : row;
+    unsigned col_end = col + 1 < b->columns ? col + 1 : col;
+    for (unsigned r = row > 0 ? row - 1 : 0; r <= row_end; r++) {
+        for (unsigned c = col > 0 ? col - 1 : 0; c <= col_end; c++) {
+            board_draw_tile(b, (size_t)r * b->columns + c,
+                            margin + (int)c * b->piece_size, margin + (int)r * b->piece_size);
+        }
+    }
 }
 
-void board_calculate_threat_levels(struct Board *b) {
-    if (!b || !b->threat_levels) {
-        return;
+// Clears the dirty flags once the queued tiles have been redrawn
+static void board_clear_dirty(struct Board *b) {
+    for (unsigned i = 0; i < b->dirty_count; i++) {
+        b->tile_dirty[b->dirty_tiles[i]] = false;
     }
-    
-    // Clear all threat levels first
-    size_t total_tiles = (size_t)(b->rows * b->columns);
-    for (size_t i = 0; i < total_tiles; i++) {
-        b->threat_levels[i] = 0;
+    b->dirty_count = 0;
+    b->layer_stale = false;
+}
+
+void board_draw(struct Board *b) {
+    // Each dirty tile redraws up to 9 tiles; past that a full redraw is cheaper
+    if (b->dirty_count * 9 >= b->rows * b->columns) {
+        b->layer_stale = true;
     }
-    
 
-    for (unsigned row = 0; row < b->rows; row++) {
-        for (unsigned col = 0; col < b->columns; col++) {
-            size_t index = (size_t)(row * b->columns + col);
-            
-            // Only calculate threat level for empty tiles (entity_id == 0)
-            if (b->entity_ids[index] == 0) {
-                unsigned threat_level = 0;
-                
-                // Check all 8 neighboring positions
-                for (int dr = -1; dr <= 1; dr++) {
-                    for (int dc = -1; dc <= 1; dc++) {
-                        // Skip the center tile (self)
-                        if (dr == 0 && dc == 0) continue;
-                        
-                        int neighbor_row = (int)row + dr;
-                        int neighbor_col = (int)col + dc;
-                        
-                        // Check if neighbor is within bounds
-                        if (neighbor_row >= 0 && neighbor_row < (int)b->rows &&
-                            neighbor_col >= 0 && neighbor_col < (int)b->columns) {
-                            
-                            unsigned neighbor_entity_id = board_get_entity_id(b, (unsigned)neighbor_row, (unsigned)neighbor_col);
-                            
-                            // Get entity level and add to threat
-                            Entity *entity = config_get_entity(&g_config, neighbor_entity_id);
-                            if (entity) {
-                                threat_level += entity->level;
-                            }
-                        }
-                    }
-                }
-                
-                b->threat_levels[index] = threat_level;
+    if (!b->layer) {
+        if (b->layer_stale || (b->dirty_count > 0 && !b->batches_ready)) {
+            board_build_batches(b, b->rect.x, b->rect.y);
+        } else if (b->dirty_count > 0) {
+            board_patch_batches(b, b->rect.x, b->rect.y);
+        }
+        board_clear_dirty(b);
+        if (b->batches_ready) {
+            board_draw_batches(b);
+        } else {
+            board_draw_all_tiles(b, b->rect.x, b->rect.y);
+        }
+        return;
+    }
+
+    if (b->layer_stale || b->dirty_count > 0) {
+        SDL_Texture *target = SDL_GetRenderTarget(b->renderer);
+        SDL_SetRenderTarget(b->renderer, b->layer);
+        SDL_SetRenderDrawBlendMode(b->renderer, SDL_BLENDMODE_NONE);
+
+        if (b->layer_stale) {
+            int margin = board_layer_margin(b);
+            SDL_SetRenderDrawColor(b->renderer, 0, 0, 0, 0);
+            SDL_RenderClear(b->renderer);
+            if (board_build_batches(b, margin, margin)) {
+                board_draw_batches(b);
+            } else {
+                board_draw_all_tiles(b, margin, margin);
             }
+        } else {
+            for (unsigned i = 0; i < b->dirty_count; i++) {
+                board_redraw_tile(b, b->dirty_tiles[i]);
+            }
+            SDL_RenderSetClipRect(b->renderer, NULL);
         }
+
+        SDL_SetRenderDrawColor(b->renderer, 0, 0, 0, 255);
+        SDL_SetRenderTarget(b->renderer, target);
+        board_clear_dirty(b);
     }
+
+    int margin = board_layer_margin(b);
+    SDL_Rect layer_rect = {
+        b->rect.x - margin, b->rect.y - margin, b->rect.w + 2 * margin, b->rect.h + 2 * margin
+    };
+    SDL_RenderCopy(b->renderer, b->layer, NULL, &layer_rect);
 }
 
-unsigned board_get_threat_level(const struct Board *b, unsigned row, unsigned col) {
-    if (!b || !b->threat_levels || row >= b->rows || col >= b->columns) {
-        return 0;
-    }
-    
-    size_t index = (size_t)(row * b->columns + col);
-    return b->threat_levels[index];
+// ========== THREAT LEVEL FUNCTIONS ==========
+
+void board_draw_threat_level_centered(const struct Board *b, unsigned threat_level, SDL_Rect tile_rect) {
+    // Center the number within the tile; the atlas already holds the black
+    // outline, so this is 2 blits per digit.
+    int text_x = tile_rect.x + (tile_rect.w - digit_atlas_width(&b->threat_digits, threat_level)) / 2;
+    int text_y = tile_rect.y + (tile_rect.h - b->threat_digits.height) / 2;
+    digit_atlas_draw(&b->threat_digits, b->renderer, threat_level, text_x, text_y);
 }
 
 // ========== ADMIN FUNCTIONS ==========
 
 void board_reveal_all_tiles(struct Board *b) {
-    printf("Revealing all %ux%u tiles...\n", b->rows, b->columns);
+    LOG_INFO(LOG_CAT_ADMIN, "Revealing all %ux%u tiles...", b->rows, b->columns);
     
     for (unsigned r = 0; r < b->rows; r++) {
         for (unsigned c = 0; c < b->columns; c++) {
-            TileState current_state = board_get_tile_state(b, r, c);
-            
-            if (current_state == TILE_HIDDEN) {
-                // Reveal the tile immediately (no animation for admin reveal)
-                board_set_tile_state(b, r, c, TILE_REVEALED);
+            if (game_state_tile_state(b->state, r, c) == TILE_HIDDEN) {
+                // Clear any ongoing animation so the reveal sets the final sprite
+                board_cancel_animation(b, (size_t)(r * b->columns + c));
                 
-                // Update display sprite immediately
-                size_t index = (size_t)(r * b->columns + c);
-                unsigned entity_id = b->entity_ids[index];
-                b->display_sprites[index] = get_entity_sprite_index(entity_id, TILE_REVEALED);
-                
-                // Clear any ongoing animation
-                b->animations[index].type = ANIM_NONE;
+                // Reveal the tile immediately (no animation for admin reveal)
+                game_state_reveal(b->state, r, c);
             }
         }
     }
     
-    printf("All tiles revealed!\n");
-}
-
-const GameConfig* board_get_config(void) {
-    return &g_config;
+    LOG_INFO(LOG_CAT_ADMIN, "All tiles revealed!");
 }
@@ -1,11 +1,17 @@
 #ifndef BOARD_H
 #define BOARD_H
 
-#include "config.h"
+#include "game_state.h"
+#include "digit_atlas.h"
+#include "tile_atlas.h"
+#include "render_batch.h"
 
 // Forward declaration to avoid circular dependency
 struct Game;
 
+// PCG stream for hidden tile looks, seeded with the game seed
+#define BOARD_TILE_RNG_STREAM 1
+
 // Animation types for tile transitions
 typedef enum {
     ANIM_NONE = 0,
@@ -25,41 +31,66 @@ typedef struct {
     unsigned start_sprite;   // Starting sprite index
     unsigned end_sprite;     // Target sprite index
     bool blocks_input;       // Can user click during this animation?
+    unsigned active_slot;    // Position in Board.active_animations while type != ANIM_NONE
 } TileAnimation;
 
-// Tile states
+// What the variable-length batches hold for a tile
+#define BOARD_BATCHED_REVEALED 0x1u     // Border and edges
+#define BOARD_BATCHED_DIGITS 0x2u       // Threat level digits
+
+// Full redraws are built into one batch per texture and drawn in this order
 typedef enum {
-    TILE_HIDDEN = 0,
-    TILE_REVEALED = 1
-} TileState;
+    BOARD_BATCH_BORDERS = 0, // Revealed tile borders, under all tile content
+    BOARD_BATCH_HIDDEN,      // Hidden tiles from the tile atlas, one slot per tile
+    BOARD_BATCH_BACKGROUNDS, // Revealed tile fills, one slot per tile
+    BOARD_BATCH_SPRITES,     // Entity sprites, one slot per tile
+    BOARD_BATCH_EDGES,       // Border parts that lie over earlier tiles
+    BOARD_BATCH_DIGITS,      // Threat levels, cut where later tiles cover them
+    BOARD_BATCH_COUNT
+} BoardBatch;
 
 struct Board {
         SDL_Renderer *renderer;
         SDL_Texture *entity_sprites;     // Single sprite sheet for all entities
         SDL_Rect *entity_src_rects;      // Source rectangles for entity sprites
         
-        SDL_Texture *tile_sprites;       // Tile sprite sheet (tile-16x16.png)
-        SDL_Rect *tile_src_rects;        // Source rectangles for tile sprites
+        TileAtlas tile_atlas;            // Hidden tile looks baked from tile-16x16.png
         
-        // Core game data (immediate updates)
-        unsigned *entity_ids;            // 1D array: entity ID occupying each cell
-        TileState *tile_states;          // 1D array: hidden/revealed mask
+        // Game rules shown by this board; it follows changes as the observer
+        GameState *state;
         
         // Tile variation data for TILE_HIDDEN
-        unsigned *tile_variations;       // 1D array: random tile variation (0-3)
-        unsigned *tile_rotations;        // 1D array: random rotation (0-3)
+        unsigned *hidden_tiles;          // 1D array: random look, index into tile_atlas.hidden
+        Rng tile_rng;                    // Picks hidden_tiles; apart from state->rng so looks never change play
         
         // Animation system (visual updates)
         TileAnimation *animations;       // 1D array: animation state per tile
         unsigned *display_sprites;       // 1D array: current visual sprite index
+        unsigned *active_animations;     // Min-heap of animating tile indices by end time
+        unsigned active_count;
+        
+        // Cached board layer: tiles are drawn into it only when they change and
+        // the whole board is presented with one copy per frame
+        SDL_Texture *layer;              // Render target, NULL if it could not be created
+        bool layer_stale;                // Redraw every tile on the next board_draw
+        bool *tile_dirty;                // 1D array: tile queued in dirty_tiles
+        unsigned *dirty_tiles;           // Tiles to redraw on the next board_draw
+        unsigned dirty_count;
         
-        // Threat level system (minesweeper logic)
-        unsigned *threat_levels;         // 1D array: calculated threat levels for empty tiles
+        // Full redraws go through these instead of per-tile copies. Without a
+        // layer they are drawn every frame; a changed tile patches its slots
+        // and the other batches are rebuilt only when a reveal or threat
+        // level changes them.
+        RenderBatch batches[BOARD_BATCH_COUNT];
+        bool batches_ready;              // Last build succeeded
+        Uint8 *batched_tiles;            // 1D array: BOARD_BATCHED_* as last built
         
         // TTF font rendering for threat levels
         TTF_Font *threat_font;           // TTF font for threat level display
+        int threat_font_scale;           // Board scale threat_font was opened at
+        DigitAtlas threat_digits;        // Outlined threat digits rendered from threat_font
         
-        unsigned rows;
+        unsigned rows;                   // Same as state->rows and state->columns
         unsigned columns;
         int scale;
         int piece_size;
@@ -82,13 +113,11 @@ struct Pos {
  * @brief Create a new game board
  * @param board Double pointer to store the allocated board
  * @param renderer SDL renderer for graphics
- * @param rows Number of rows in the board
- * @param columns Number of columns in the board
+ * @param state Game state to show, sized before the board is created
  * @param scale Scaling factor for display
  * @return true on success, false on failure
  */
-bool board_new(struct Board **board, SDL_Renderer *renderer, unsigned rows,
-               unsigned columns, int scale);
+bool board_new(struct Board **board, SDL_Renderer *renderer, GameState *state, int scale);
 
 /**
  * @brief Free a board and all associated resources
@@ -97,40 +126,38 @@ bool board_new(struct Board **board, SDL_Renderer *renderer, unsigned rows,
 void board_free(struct Board **board);
 
 /**
- * @brief Reset the board to initial state
+ * @brief Reallocate the tiles for the state's size and pick new hidden looks
  * @param b Pointer to the board
  * @return true on success, false on failure
  */
 bool board_reset(struct Board *b);
+// Drops animations and redraws every tile after the game state was loaded or cleared
+void board_sync_tiles(struct Board *b);
 void board_set_scale(struct Board *b, int scale);
 void board_set_theme(struct Board *b, unsigned theme);
-void board_set_size(struct Board *b, unsigned rows, unsigned columns);
-void board_draw(const struct Board *b);
+bool board_set_size(struct Board *b, unsigned rows, unsigned columns);
+void board_draw(struct Board *b);
 
-// Core game state access
-unsigned board_get_entity_id(const struct Board *b, unsigned row, unsigned col);
-void board_set_entity_id(struct Board *b, unsigned row, unsigned col, unsigned entity_id);
-TileState board_get_tile_state(const struct Board *b, unsigned row, unsigned col);
-void board_set_tile_state(struct Board *b, unsigned row, unsigned col, TileState state);
+// Queues a tile for redraw into the board layer after its state, entity,
+// display sprite or threat level changed
+void board_mark_tile_dirty(struct Board *b, size_t index);
+// Redraws the whole layer on the next frame, e.g. after SDL_RENDER_TARGETS_RESET
+void board_invalidate_layer(struct Board *b);
 
 // Animation system
 void board_update_animations(struct Board *b);
+// Adds the tile to the active set, or moves it after its end time changed
+void board_schedule_animation(struct Board *b, size_t index);
+// Stops the tile's animation and drops it from the active set
+void board_cancel_animation(struct Board *b, size_t index);
 bool board_is_tile_animating(const struct Board *b, unsigned row, unsigned col);
-unsigned get_entity_sprite_index(unsigned entity_id, TileState tile_state);
-
-// Game logic
-bool board_load_solution(struct Board *b, const char *solution_file, unsigned solution_index);
+bool board_has_animations(const struct Board *b);
+unsigned get_entity_sprite_index(const GameConfig *config, unsigned entity_id, TileState tile_state);
 
 // Admin functions
 void board_reveal_all_tiles(struct Board *b);
 
-// Config access
-const GameConfig* board_get_config(void);
-
-// Threat level system (minesweeper logic)
-void board_calculate_threat_levels(struct Board *b);
-unsigned board_get_threat_level(const struct Board *b, unsigned row, unsigned col);
-void board_draw_threat_level_text(const struct Board *b, const char *text, int x, int y, SDL_Color color);
-void board_draw_threat_level_text_centered(const struct Board *b, const char *text, SDL_Rect tile_rect);
+// Threat level text
+void board_draw_threat_level_centered(const struct Board *b, unsigned threat_level, SDL_Rect tile_rect);
 
 #endif
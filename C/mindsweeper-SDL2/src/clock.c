@@ -132,9 +132,13 @@ void clock_update(struct Clock *c) {
         elapsed_time = (Uint32)-1 - c->last_time + current_time;
     }
 
+    // Catch up on every second missed while the game loop was asleep
     if (elapsed_time > 1000) {
-        c->last_time += 1000;
-        c->seconds++;
+        while (elapsed_time > 1000) {
+            c->last_time += 1000;
+            c->seconds++;
+            elapsed_time -= 1000;
+        }
         clock_update_digits(c);
     }
 }
@@ -1,854 +1,537 @@
 #include "config.h"
+#include "json_reader.h"
+#include "log.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-#ifdef WASM_BUILD
-// WASM implementations - simplified but functional
+// config_v2.json is read with the streaming tokenizer in json_reader.h in both
+// builds: one forward pass over the file buffer, keeping only the fields the
+// game uses and skipping the rest without copying it.
 
-static char* read_file_contents_wasm(const char *filename) {
-    FILE *file = fopen(filename, "r");
+static char* read_file_contents(const char *filename, size_t *length) {
+    FILE *file = fopen(filename, "rb");
     if (!file) {
-        fprintf(stderr, "WASM: Failed to open file: %s\n", filename);
+        fprintf(stderr, "Failed to open file: %s\n", filename);
         return NULL;
     }
-    
+
     fseek(file, 0, SEEK_END);
-    long length = ftell(file);
+    long file_length = ftell(file);
     fseek(file, 0, SEEK_SET);
-    
-    char *content = malloc((size_t)length + 1);
+    if (file_length < 0) {
+        fprintf(stderr, "Failed to size file: %s\n", filename);
+        fclose(file);
+        return NULL;
+    }
+
+    char *content = malloc((size_t)file_length + 1);
     if (!content) {
+        fprintf(stderr, "Error in malloc of file buffer.\n");
         fclose(file);
         return NULL;
     }
-    
-    fread(content, 1, (size_t)length, file);
-    content[length] = '\0';
+
+    *length = fread(content, 1, (size_t)file_length, file);
+    content[*length] = '\0';
     fclose(file);
-    
+
     return content;
 }
 
-// Simple JSON parser for solution data - handles the specific structure we need
-static char* find_json_string(const char *json, const char *key) {
-    char search_pattern[128];
-    snprintf(search_pattern, sizeof(search_pattern), "\"%s\":", key);
-    
-    char *pos = strstr(json, search_pattern);
-    if (!pos) return NULL;
-    
-    pos += strlen(search_pattern);
-    while (*pos == ' ' || *pos == '\t') pos++; // Skip whitespace
-    
-    if (*pos != '"') return NULL;
-    pos++; // Skip opening quote
-    
-    char *end = strchr(pos, '"');
-    if (!end) return NULL;
-    
-    size_t len = (size_t)(end - pos);
-    char *result = malloc(len + 1);
-    strncpy(result, pos, len);
-    result[len] = '\0';
-    
-    return result;
+static bool config_read_unsigned(const JsonToken *value, const char *field, unsigned *out) {
+    if (!json_token_unsigned(value, out)) {
+        fprintf(stderr, "Config field '%s' must be a non-negative integer\n", field);
+        return false;
+    }
+    return true;
 }
 
-static char* find_board_array(const char *json) {
-    char *board_pos = strstr(json, "\"board\":");
-    if (!board_pos) return NULL;
-    
-    board_pos += 8; // Skip "board":
-    while (*board_pos == ' ' || *board_pos == '\t') board_pos++;
-    
-    if (*board_pos != '[') return NULL;
-    
-    // Find the matching closing bracket
-    int bracket_count = 0;
-    char *start = board_pos;
-    char *pos = board_pos;
-    
-    do {
-        if (*pos == '[') bracket_count++;
-        else if (*pos == ']') bracket_count--;
-        pos++;
-    } while (bracket_count > 0 && *pos != '\0');
-    
-    size_t len = (size_t)(pos - start);
-    char *result = malloc(len + 1);
-    strncpy(result, start, len);
-    result[len] = '\0';
-    
-    return result;
+static bool config_read_string(const JsonToken *value, const char *field, char *out, size_t out_size) {
+    if (!json_token_copy_string(value, out, out_size)) {
+        fprintf(stderr, "Config field '%s' must be a string shorter than %zu bytes\n",
+                field, out_size);
+        return false;
+    }
+    return true;
 }
 
-static bool parse_board_array(const char *board_json, SolutionData *solution) {
-    // Count rows (number of '[' at start of lines)
-    solution->rows = 0;
-    const char *pos = board_json;
-    while ((pos = strchr(pos, '[')) != NULL) {
-        // Check if this is a row start (not the main array start)
-        if (pos > board_json && *(pos-1) != ':') {
-            solution->rows++;
-        }
-        pos++;
+// Expects the token just read to open an object or array
+static bool config_expect(const JsonToken *value, JsonTokenType type, const char *field) {
+    if (value->type != type) {
+        fprintf(stderr, "Config field '%s' must be an %s\n", field,
+                type == JSON_TOKEN_OBJECT_BEGIN ? "object" : "array");
+        return false;
     }
-    
-    if (solution->rows == 0) return false;
-    
-    // Find first row to count columns
-    pos = strchr(board_json, '[');
-    if (!pos) return false;
-    pos = strchr(pos + 1, '['); // Skip main array start, find first row
-    if (!pos) return false;
-    
-    solution->cols = 0;
-    pos++; // Skip '['
-    while (*pos != ']' && *pos != '\0') {
-        if (*pos >= '0' && *pos <= '9') {
-            solution->cols++;
-            // Skip to next number
-            while (*pos != ',' && *pos != ']' && *pos != '\0') pos++;
-            if (*pos == ',') pos++;
+    return true;
+}
+
+static bool config_parse_game_state(JsonReader *r, GameConfig *config) {
+    JsonToken key, value;
+    while (json_reader_member(r, &key, &value)) {
+        bool ok = true;
+        if (json_token_equals(&key, "starting_max_health")) {
+            ok = config_read_unsigned(&value, "starting_max_health", &config->starting_health);
+        } else if (json_token_equals(&key, "starting_max_experience")) {
+            ok = config_read_unsigned(&value, "starting_max_experience", &config->starting_experience);
+        } else if (json_token_equals(&key, "starting_level")) {
+            ok = config_read_unsigned(&value, "starting_level", &config->starting_level);
         } else {
-            pos++;
+            ok = json_reader_skip(r, &value);
         }
-    }
-    
-    // Allocate 2D array
-    solution->board = malloc(solution->rows * sizeof(unsigned*));
-    for (unsigned i = 0; i < solution->rows; i++) {
-        solution->board[i] = malloc(solution->cols * sizeof(unsigned));
-    }
-    
-    // Parse all numbers
-    pos = board_json;
-    unsigned row = 0, col = 0;
-    bool in_row = false;
-    
-    while (*pos != '\0' && row < solution->rows) {
-        if (*pos == '[' && in_row) {
-            // Start of a new row
-            col = 0;
-        } else if (*pos == '[' && !in_row) {
-            // Check if this is a row start
-            if (pos > board_json && *(pos-1) != ':') {
-                in_row = true;
-                col = 0;
-            }
-        } else if (*pos == ']' && in_row) {
-            // End of row
-            row++;
-            in_row = false;
-        } else if ((*pos >= '0' && *pos <= '9') && in_row && col < solution->cols) {
-            // Parse number
-            unsigned num = 0;
-            while (*pos >= '0' && *pos <= '9') {
-                num = num * 10 + (unsigned)(*pos - '0');
-                pos++;
-            }
-            solution->board[row][col] = num;
-            col++;
-            continue; // Don't increment pos again
+        if (!ok) {
+            return false;
         }
-        pos++;
     }
-    
-    return true;
+    return !json_reader_failed(r);
 }
 
-static bool parse_wasm_entities(const char *content, GameConfig *config) {
-    // Find entities array start
-    char *entities_start = strstr(content, "\"entities\":");
-    if (!entities_start) {
-        printf("WASM: Could not find 'entities' key in config\n");
-        return false;
-    }
-    
-    entities_start = strchr(entities_start, '[');
-    if (!entities_start) {
-        printf("WASM: Could not find entities array start\n");
-        return false;
-    }
-    
-    // Find entities array end
-    char *entities_end = entities_start;
-    int bracket_count = 0;
-    do {
-        if (*entities_end == '[') bracket_count++;
-        else if (*entities_end == ']') bracket_count--;
-        entities_end++;
-    } while (bracket_count > 0 && *entities_end != '\0');
-    
-    if (bracket_count != 0) {
-        printf("WASM: Could not find entities array end\n");
-        return false;
-    }
-    
-    // Count entities by looking for "id": pattern within entities array
-    unsigned entity_count = 0;
-    char *pos = entities_start;
-    while (pos < entities_end && (pos = strstr(pos, "\"id\":")) != NULL) {
-        entity_count++;
-        pos += 5; // Move past "id":
-    }
-    
-    if (entity_count == 0) {
-        printf("WASM: Found 0 entities\n");
-        return false;
-    }
-    
-    printf("WASM: Found %u entities in config\n", entity_count);
-    config->entity_count = entity_count;
-    config->entities = calloc(entity_count, sizeof(Entity));
-    
-    // Parse each entity by finding "id": patterns
-    pos = entities_start;
-    unsigned parsed_entities = 0;
-    
-    while (parsed_entities < entity_count && pos < entities_end && (pos = strstr(pos, "\"id\":")) != NULL) {
-        // Find the start of this entity object (work backwards to find '{')
-        char *entity_start = pos;
-        while (entity_start > entities_start && *entity_start != '{') {
-            entity_start--;
-        }
-        
-        if (*entity_start != '{') {
-            printf("WASM: Could not find entity start for entity %u\n", parsed_entities);
-            pos += 5;
-            continue;
-        }
-        
-        // Find end of this entity
-        int brace_count = 0;
-        char *entity_end = entity_start;
-        do {
-            if (*entity_end == '{') brace_count++;
-            else if (*entity_end == '}') brace_count--;
-            entity_end++;
-        } while (brace_count > 0 && *entity_end != '\0' && entity_end < entities_end);
-        
-        // Extract entity JSON
-        size_t entity_len = (size_t)(entity_end - entity_start);
-        char *entity_json = malloc(entity_len + 1);
-        strncpy(entity_json, entity_start, entity_len);
-        entity_json[entity_len] = '\0';
-        
-        Entity *e = &config->entities[parsed_entities];
-        
-        // Parse ID (we know this exists since we found it)
-        char *id_pos = strstr(entity_json, "\"id\":");
-        if (id_pos) {
-            id_pos += 5;
-            while (*id_pos == ' ' || *id_pos == '\t') id_pos++;
-            e->id = (unsigned)atoi(id_pos);
-        }
-        
-        // Parse name
-        char *name = find_json_string(entity_json, "name");
-        if (name) {
-            strncpy(e->name, name, sizeof(e->name) - 1);
-            e->name[sizeof(e->name) - 1] = '\0';
-            free(name);
+static bool config_parse_tags(JsonReader *r, Entity *e) {
+    JsonToken value;
+    while (json_reader_element(r, &value)) {
+        if (e->tag_count >= MAX_ENTITY_TAGS) {
+            fprintf(stderr, "Entity %u has more than %d tags\n", e->id, MAX_ENTITY_TAGS);
+            return false;
         }
-        
-        // Parse description
-        char *desc = find_json_string(entity_json, "description");
-        if (desc) {
-            strncpy(e->description, desc, sizeof(e->description) - 1);
-            e->description[sizeof(e->description) - 1] = '\0';
-            free(desc);
+
+        char *tag = e->tags[e->tag_count];
+        if (!config_read_string(&value, "tags", tag, MAX_TAG_LENGTH)) {
+            return false;
         }
-        
-        // Parse level
-        char *level_pos = strstr(entity_json, "\"level\":");
-        if (level_pos) {
-            level_pos += 8;
-            while (*level_pos == ' ' || *level_pos == '\t') level_pos++;
-            e->level = (unsigned)atoi(level_pos);
+
+        // Set compatibility flags
+        if (strcmp(tag, "enemy") == 0) {
+            e->is_enemy = true;
+        } else if (strcmp(tag, "item") == 0) {
+            e->is_item = true;
+        } else if (strcmp(tag, "revealed-click-trigger") == 0) {
+            e->is_trigger = true;
+        } else if (strcmp(tag, "no-experience") == 0) {
+            e->no_experience = true;
         }
-        
-        // Parse tags array
-        e->tag_count = 0;
-        e->is_enemy = false;
-        e->is_item = false;
-        
-        char *tags_pos = strstr(entity_json, "\"tags\":");
-        if (tags_pos) {
-            tags_pos = strchr(tags_pos, '[');
-            if (tags_pos) {
-                char *tags_end = strchr(tags_pos, ']');
-                if (tags_end) {
-                    // Extract tags array content
-                    size_t tags_len = (size_t)(tags_end - tags_pos + 1);
-                    char *tags_array = malloc(tags_len + 1);
-                    strncpy(tags_array, tags_pos, tags_len);
-                    tags_array[tags_len] = '\0';
-                    
-                    // Parse individual tags
-                    char *tag_start = tags_array;
-                    while ((tag_start = strchr(tag_start, '"')) != NULL && e->tag_count < MAX_ENTITY_TAGS) {
-                        tag_start++; // Skip opening quote
-                        char *tag_end = strchr(tag_start, '"');
-                        if (!tag_end) break;
-                        
-                        size_t tag_len = (size_t)(tag_end - tag_start);
-                        if (tag_len > 0 && tag_len < MAX_TAG_LENGTH) {
-                            strncpy(e->tags[e->tag_count], tag_start, tag_len);
-                            e->tags[e->tag_count][tag_len] = '\0';
-                            
-                            // Set compatibility flags
-                            if (strcmp(e->tags[e->tag_count], "enemy") == 0) {
-                                e->is_enemy = true;
-                            } else if (strcmp(e->tags[e->tag_count], "item") == 0) {
-                                e->is_item = true;
-                            }
-                            
-                            e->tag_count++;
-                        }
-                        
-                        tag_start = tag_end + 1;
-                    }
-                    
-                    free(tags_array);
-                }
-            }
+
+        e->tag_count++;
+    }
+    return !json_reader_failed(r);
+}
+
+static bool config_parse_sprites(JsonReader *r, Entity *e) {
+    JsonToken key, value;
+    while (json_reader_member(r, &key, &value)) {
+        if (!json_token_equals(&key, "revealed")) {
+            if (!json_reader_skip(r, &value)) return false;
+            continue;
         }
-        
-        // Parse sprite position (look for first x and y in revealed section)
-        char *sprites_pos = strstr(entity_json, "\"sprites\":");
-        if (sprites_pos) {
-            char *revealed_pos = strstr(sprites_pos, "\"revealed\":");
-            if (revealed_pos) {
-                char *x_pos = strstr(revealed_pos, "\"x\":");
-                char *y_pos = strstr(revealed_pos, "\"y\":");
-                if (x_pos && y_pos && x_pos < (revealed_pos + 200) && y_pos < (revealed_pos + 200)) {
-                    x_pos += 4;
-                    while (*x_pos == ' ' || *x_pos == '\t') x_pos++;
-                    e->sprite_pos.x = (unsigned)atoi(x_pos);
-                    
-                    y_pos += 4;
-                    while (*y_pos == ' ' || *y_pos == '\t') y_pos++;
-                    e->sprite_pos.y = (unsigned)atoi(y_pos);
-                }
-            }
+        if (!config_expect(&value, JSON_TOKEN_OBJECT_BEGIN, "sprites.revealed")) {
+            return false;
         }
-        
-        // Parse entity transition (simplified)
-        char *transition_pos = strstr(entity_json, "\"entity_transition\":");
-        if (transition_pos) {
-            char *cleared_pos = strstr(transition_pos, "\"on_cleared\":");
-            if (cleared_pos) {
-                char *entity_id_pos = strstr(cleared_pos, "\"entity_id\":");
-                if (entity_id_pos) {
-                    entity_id_pos += 12;
-                    while (*entity_id_pos == ' ' || *entity_id_pos == '\t') entity_id_pos++;
-                    e->transition.next_entity_id = (unsigned)atoi(entity_id_pos);
-                }
-                
-                char *sound = find_json_string(cleared_pos, "sound");
-                if (sound) {
-                    strncpy(e->transition.sound, sound, sizeof(e->transition.sound) - 1);
-                    e->transition.sound[sizeof(e->transition.sound) - 1] = '\0';
-                    free(sound);
-                }
+
+        JsonToken pos_key, pos_value;
+        while (json_reader_member(r, &pos_key, &pos_value)) {
+            bool ok = true;
+            if (json_token_equals(&pos_key, "x")) {
+                ok = config_read_unsigned(&pos_value, "sprites.revealed.x", &e->sprite_pos.x);
+            } else if (json_token_equals(&pos_key, "y")) {
+                ok = config_read_unsigned(&pos_value, "sprites.revealed.y", &e->sprite_pos.y);
+            } else {
+                ok = json_reader_skip(r, &pos_value);
             }
-        } else {
-            // Default: no transition (stays same entity)
-            e->transition.next_entity_id = e->id;
+            if (!ok) return false;
         }
-        
-        printf("WASM: Parsed entity %u: ID=%u, Name='%s', Level=%u, Sprite=(%u,%u)\n", 
-               parsed_entities, e->id, e->name, e->level, e->sprite_pos.x, e->sprite_pos.y);
-        
-        free(entity_json);
-        parsed_entities++;
-        pos += 5; // Move past current "id":
     }
-    
-    printf("WASM: Successfully parsed %u entities\n", parsed_entities);
-    return parsed_entities > 0;
+    return !json_reader_failed(r);
 }
 
-bool config_load(GameConfig *config, const char *config_file) {
-    printf("WASM: Loading config from %s\n", config_file);
-    
-    char *content = read_file_contents_wasm(config_file);
-    if (!content) {
-        printf("WASM: Failed to read config file, using minimal defaults\n");
-        // Minimal fallback
-        config->rows = 10;
-        config->cols = 14;
-        config->starting_health = 8;
-        config->starting_experience = 5;
-        config->starting_level = 2;
-        config->entity_count = 1;
-        config->entities = calloc(1, sizeof(Entity));
-        config->entities[0].id = 0;
-        strcpy(config->entities[0].name, "Empty");
-        config->entities[0].tag_count = 0;
-        config->entities[0].is_enemy = false;
-        config->entities[0].is_item = false;
-        return true;
-    }
-    
-    // Parse basic config values
-    config->rows = 10;
-    config->cols = 14;
-    config->starting_health = 8;
-    config->starting_experience = 5;
-    config->starting_level = 2;
-    
-    // Parse game_state section
-    char *game_state_pos = strstr(content, "\"game_state\":");
-    if (game_state_pos) {
-        char *health_pos = strstr(game_state_pos, "\"starting_max_health\":");
-        if (health_pos) {
-            health_pos += 22;
-            while (*health_pos == ' ' || *health_pos == '\t') health_pos++;
-            config->starting_health = (unsigned)atoi(health_pos);
+// Compiles a random_choice "choices" array into the entity's alias table
+static bool config_parse_choices(JsonReader *r, Entity *e) {
+    unsigned *entity_ids = NULL;
+    unsigned *weights = NULL;
+    unsigned count = 0;
+    unsigned capacity = 0;
+    bool ok = false;
+
+    JsonToken value;
+    while (json_reader_element(r, &value)) {
+        if (!config_expect(&value, JSON_TOKEN_OBJECT_BEGIN, "on_cleared.choices[]")) {
+            goto cleanup;
         }
-        
-        char *exp_pos = strstr(game_state_pos, "\"starting_max_experience\":");
-        if (exp_pos) {
-            exp_pos += 26;
-            while (*exp_pos == ' ' || *exp_pos == '\t') exp_pos++;
-            config->starting_experience = (unsigned)atoi(exp_pos);
+
+        if (count == capacity) {
+            capacity = capacity ? capacity * 2 : 4;
+            unsigned *new_ids = realloc(entity_ids, capacity * sizeof(unsigned));
+            if (new_ids) {
+                entity_ids = new_ids;
+            }
+            unsigned *new_weights = realloc(weights, capacity * sizeof(unsigned));
+            if (new_weights) {
+                weights = new_weights;
+            }
+            if (!new_ids || !new_weights) {
+                fprintf(stderr, "Error in realloc of transition choices.\n");
+                goto cleanup;
+            }
+        }
+
+        bool has_id = false;
+        entity_ids[count] = 0;
+        weights[count] = 1;
+
+        JsonToken choice_key, choice_value;
+        while (json_reader_member(r, &choice_key, &choice_value)) {
+            bool field_ok = true;
+            if (json_token_equals(&choice_key, "entity_id")) {
+                field_ok = config_read_unsigned(&choice_value, "choices.entity_id", &entity_ids[count]);
+                has_id = true;
+            } else if (json_token_equals(&choice_key, "weight")) {
+                field_ok = config_read_unsigned(&choice_value, "choices.weight", &weights[count]);
+            } else if (count == 0 && json_token_equals(&choice_key, "sound")) {
+                // One sound per transition; the first choice's stands for all
+                field_ok = config_read_string(&choice_value, "choices.sound",
+                                              e->transition.sound, sizeof(e->transition.sound));
+            } else {
+                field_ok = json_reader_skip(r, &choice_value);
+            }
+            if (!field_ok) goto cleanup;
         }
-        
-        char *level_pos = strstr(game_state_pos, "\"starting_level\":");
-        if (level_pos) {
-            level_pos += 17;
-            while (*level_pos == ' ' || *level_pos == '\t') level_pos++;
-            config->starting_level = (unsigned)atoi(level_pos);
+        if (json_reader_failed(r)) goto cleanup;
+        if (!has_id) {
+            fprintf(stderr, "Entity %u has a transition choice without entity_id\n", e->id);
+            goto cleanup;
         }
+        count++;
     }
-    
-    // Parse entities
-    if (!parse_wasm_entities(content, config)) {
-        printf("WASM: Failed to parse entities, using fallback\n");
-        config->entity_count = 2;
-        config->entities = calloc(2, sizeof(Entity));
-        
-        // Entity 0: Empty
-        config->entities[0].id = 0;
-        strcpy(config->entities[0].name, "Empty");
-        strcpy(config->entities[0].description, "An empty tile");
-        config->entities[0].sprite_pos.x = 3;
-        config->entities[0].sprite_pos.y = 4;
-        config->entities[0].tag_count = 0;
-        config->entities[0].is_enemy = false;
-        config->entities[0].is_item = false;
-        
-        // Entity 1: Cave Rat
-        config->entities[1].id = 1;
-        strcpy(config->entities[1].name, "Cave Rat");
-        strcpy(config->entities[1].description, "A small rodent");
-        config->entities[1].level = 1;
-        config->entities[1].is_enemy = true;
-        config->entities[1].sprite_pos.x = 0;
-        config->entities[1].sprite_pos.y = 0;
-        config->entities[1].transition.next_entity_id = 0;
-        strcpy(config->entities[1].transition.sound, "crystal");
-        config->entities[1].tag_count = 1;
-        strcpy(config->entities[1].tags[0], "enemy");
-        config->entities[1].is_item = false;
+    if (json_reader_failed(r)) goto cleanup;
+
+    if (!alias_table_build(&e->transition.choices, entity_ids, weights, count)) {
+        fprintf(stderr, "Entity %u has no valid random_choice weights\n", e->id);
+        goto cleanup;
     }
-    
-    free(content);
-    
-    printf("WASM: Loaded config with %u entities, starting level %u, health %u\n", 
-           config->entity_count, config->starting_level, config->starting_health);
-    
-    return true;
+    ok = true;
+
+cleanup:
+    free(entity_ids);
+    free(weights);
+    return ok;
 }
 
-bool config_load_solution(SolutionData *solution, const char *solution_file, unsigned solution_index) {
-    printf("WASM: Loading solution from %s, index %u\n", solution_file, solution_index);
-    
-    char *content = read_file_contents_wasm(solution_file);
-    if (!content) {
-        printf("WASM: Failed to read solution file, using fallback\n");
-        // Fallback to hardcoded solution
-        solution->rows = 10;
-        solution->cols = 14;
-        strcpy(solution->uuid, "wasm-fallback-board");
-        
-        solution->board = malloc(solution->rows * sizeof(unsigned*));
-        for (unsigned i = 0; i < solution->rows; i++) {
-            solution->board[i] = malloc(solution->cols * sizeof(unsigned));
-            for (unsigned j = 0; j < solution->cols; j++) {
-                if ((i + j) % 7 == 0) {
-                    solution->board[i][j] = 1; // Dragon
-                } else {
-                    solution->board[i][j] = 0; // Empty
+static bool config_parse_transition(JsonReader *r, Entity *e) {
+    JsonToken key, value;
+    while (json_reader_member(r, &key, &value)) {
+        if (!json_token_equals(&key, "on_cleared")) {
+            if (!json_reader_skip(r, &value)) return false;
+            continue;
+        }
+        if (!config_expect(&value, JSON_TOKEN_OBJECT_BEGIN, "entity_transition.on_cleared")) {
+            return false;
+        }
+
+        // A random_choice transition has no entity_id of its own; next_entity_id
+        // stays Empty and the choices table decides.
+        e->transition.next_entity_id = 0;
+
+        JsonToken cleared_key, cleared_value;
+        while (json_reader_member(r, &cleared_key, &cleared_value)) {
+            bool ok = true;
+            if (json_token_equals(&cleared_key, "choices")) {
+                if (e->transition.choices.count > 0) {
+                    fprintf(stderr, "Entity %u has more than one choices list\n", e->id);
+                    return false;
                 }
+                ok = config_expect(&cleared_value, JSON_TOKEN_ARRAY_BEGIN, "on_cleared.choices") &&
+                     config_parse_choices(r, e);
+            } else if (json_token_equals(&cleared_key, "entity_id")) {
+                ok = config_read_unsigned(&cleared_value, "on_cleared.entity_id",
+                                          &e->transition.next_entity_id);
+            } else if (json_token_equals(&cleared_key, "sound")) {
+                ok = config_read_string(&cleared_value, "on_cleared.sound",
+                                        e->transition.sound, sizeof(e->transition.sound));
+            } else {
+                ok = json_reader_skip(r, &cleared_value);
             }
+            if (!ok) return false;
         }
-        return true;
     }
-    
-    // Find the requested solution in the JSON array
-    char *solution_start = content;
-    for (unsigned i = 0; i <= solution_index; i++) {
-        solution_start = strchr(solution_start, '{');
-        if (!solution_start) {
-            printf("WASM: Solution index %u not found\n", solution_index);
-            free(content);
-            return false;
+    return !json_reader_failed(r);
+}
+
+static bool config_parse_entity(JsonReader *r, Entity *e) {
+    bool has_id = false;
+    bool has_transition = false;
+
+    JsonToken key, value;
+    while (json_reader_member(r, &key, &value)) {
+        bool ok = true;
+        if (json_token_equals(&key, "id")) {
+            ok = config_read_unsigned(&value, "id", &e->id);
+            has_id = true;
+        } else if (json_token_equals(&key, "name")) {
+            ok = config_read_string(&value, "name", e->name, sizeof(e->name));
+        } else if (json_token_equals(&key, "description")) {
+            ok = config_read_string(&value, "description", e->description, sizeof(e->description));
+        } else if (json_token_equals(&key, "level")) {
+            ok = config_read_unsigned(&value, "level", &e->level);
+        } else if (json_token_equals(&key, "count")) {
+            // Empty has a null count; it loads as 0
+            ok = value.type == JSON_TOKEN_NULL || config_read_unsigned(&value, "count", &e->count);
+        } else if (json_token_equals(&key, "tags")) {
+            ok = config_expect(&value, JSON_TOKEN_ARRAY_BEGIN, "tags") && config_parse_tags(r, e);
+        } else if (json_token_equals(&key, "sprites")) {
+            ok = config_expect(&value, JSON_TOKEN_OBJECT_BEGIN, "sprites") && config_parse_sprites(r, e);
+        } else if (json_token_equals(&key, "entity_transition")) {
+            ok = config_expect(&value, JSON_TOKEN_OBJECT_BEGIN, "entity_transition") &&
+                 config_parse_transition(r, e);
+            has_transition = true;
+        } else {
+            ok = json_reader_skip(r, &value);
         }
-        if (i < solution_index) {
-            // Find the end of this solution and move to the next
-            int brace_count = 0;
-            char *pos = solution_start;
-            do {
-                if (*pos == '{') brace_count++;
-                else if (*pos == '}') brace_count--;
-                pos++;
-            } while (brace_count > 0 && *pos != '\0');
-            solution_start = pos;
+        if (!ok) {
+            return false;
         }
     }
-    
-    // Find the end of the current solution
-    int brace_count = 0;
-    char *solution_end = solution_start;
-    do {
-        if (*solution_end == '{') brace_count++;
-        else if (*solution_end == '}') brace_count--;
-        solution_end++;
-    } while (brace_count > 0 && *solution_end != '\0');
-    
-    // Extract just this solution
-    size_t sol_len = (size_t)(solution_end - solution_start);
-    char *solution_json = malloc(sol_len + 1);
-    strncpy(solution_json, solution_start, sol_len);
-    solution_json[sol_len] = '\0';
-    
-    // Parse UUID
-    char *uuid = find_json_string(solution_json, "uuid");
-    if (uuid) {
-        strncpy(solution->uuid, uuid, sizeof(solution->uuid) - 1);
-        solution->uuid[sizeof(solution->uuid) - 1] = '\0';
-        free(uuid);
-    } else {
-        strcpy(solution->uuid, "unknown-uuid");
+    if (json_reader_failed(r)) {
+        return false;
     }
-    
-    // Parse board array
-    char *board_json = find_board_array(solution_json);
-    if (!board_json || !parse_board_array(board_json, solution)) {
-        printf("WASM: Failed to parse board array\n");
-        free(content);
-        free(solution_json);
-        if (board_json) free(board_json);
+
+    if (!has_id) {
+        fprintf(stderr, "Config entity '%s' has no id\n", e->name);
         return false;
     }
-    
-    printf("WASM: Successfully loaded solution %u: %s (%ux%u)\n", 
-           solution_index, solution->uuid, solution->rows, solution->cols);
-    
-    free(content);
-    free(solution_json);
-    free(board_json);
+    if (!has_transition) {
+        // Default: no transition (stays same entity)
+        e->transition.next_entity_id = e->id;
+    }
     return true;
 }
 
-#else
-// Full JSON implementation for native builds
+static bool config_parse_entities(JsonReader *r, GameConfig *config) {
+    unsigned capacity = 0;
 
-static char* read_file_contents(const char *filename) {
-    FILE *file = fopen(filename, "r");
-    if (!file) {
-        fprintf(stderr, "Failed to open file: %s\n", filename);
-        return NULL;
-    }
-    
-    fseek(file, 0, SEEK_END);
-    long length = ftell(file);
-    fseek(file, 0, SEEK_SET);
-    
-    char *content = malloc((size_t)length + 1);
-    if (!content) {
-        fclose(file);
-        return NULL;
+    JsonToken value;
+    while (json_reader_element(r, &value)) {
+        if (!config_expect(&value, JSON_TOKEN_OBJECT_BEGIN, "entities[]")) {
+            return false;
+        }
+
+        if (config->entity_count == capacity) {
+            capacity = capacity ? capacity * 2 : 32;
+            Entity *entities = realloc(config->entities, capacity * sizeof(Entity));
+            if (!entities) {
+                fprintf(stderr, "Error in realloc of config entities.\n");
+                return false;
+            }
+            config->entities = entities;
+        }
+
+        Entity *e = &config->entities[config->entity_count];
+        memset(e, 0, sizeof(*e));
+        if (!config_parse_entity(r, e)) {
+            fprintf(stderr, "Invalid entity #%u in config\n", config->entity_count);
+            alias_table_free(&e->transition.choices);
+            return false;
+        }
+        config->entity_count++;
     }
-    
-    fread(content, 1, (size_t)length, file);
-    content[length] = '\0';
-    fclose(file);
-    
-    return content;
+    return !json_reader_failed(r);
 }
 
-bool config_load(GameConfig *config, const char *config_file) {
-    char *content = read_file_contents(config_file);
-    if (!content) {
+// Reads the number at *text into *out and moves *text past it
+static bool config_scan_number(const char **text, unsigned long *out) {
+    char *end;
+    if (**text < '0' || **text > '9') {
         return false;
     }
-    
-    cJSON *json = cJSON_Parse(content);
-    free(content);
-    
-    if (!json) {
-        fprintf(stderr, "Failed to parse JSON config\n");
+    *out = strtoul(*text, &end, 10);
+    *text = end;
+    return true;
+}
+
+// Matches tags of the form <prefix>N<suffix> and reads N
+static bool config_tag_number(const char *tag, const char *prefix, const char *suffix, unsigned long *out) {
+    size_t prefix_length = strlen(prefix);
+    if (strncmp(tag, prefix, prefix_length) != 0) {
         return false;
     }
-    
-    // Parse game state
-    cJSON *game_state = cJSON_GetObjectItem(json, "game_state");
-    if (game_state) {
-        // Print the game_state JSON object
-        char *game_state_str = cJSON_Print(game_state);
-        printf("Game state JSON: %s\n", game_state_str);
-        free(game_state_str);
-        
-        config->rows = (unsigned)cJSON_GetNumberValue(cJSON_GetObjectItem(json, "rows"));
-        config->cols = (unsigned)cJSON_GetNumberValue(cJSON_GetObjectItem(json, "cols"));
-        config->starting_health = (unsigned)cJSON_GetNumberValue(cJSON_GetObjectItem(game_state, "starting_max_health"));
-        config->starting_experience = (unsigned)cJSON_GetNumberValue(cJSON_GetObjectItem(game_state, "starting_max_experience"));
-        config->starting_level = (unsigned)cJSON_GetNumberValue(cJSON_GetObjectItem(game_state, "starting_level"));
+    const char *rest = tag + prefix_length;
+    return config_scan_number(&rest, out) && strcmp(rest, suffix) == 0;
+}
+
+static bool config_add_effect(Entity *e, EffectOpcode opcode, unsigned long argument) {
+    if (argument > UINT16_MAX) {
+        fprintf(stderr, "Entity %u has an effect argument over %u\n", e->id, UINT16_MAX);
+        return false;
     }
-    
-    
-    // Parse entities
-    cJSON *entities = cJSON_GetObjectItem(json, "entities");
-    if (entities) {
-        // Print the entities JSON array
-        // char *entities_str = cJSON_Print(entities);
-        // printf("Entities JSON: %s\n", entities_str);
-        // free(entities_str);
-        
-        config->entity_count = (unsigned)cJSON_GetArraySize(entities);
-        config->entities = calloc(config->entity_count, sizeof(Entity));
-        
-        for (unsigned i = 0; i < config->entity_count; i++) {
-            cJSON *entity = cJSON_GetArrayItem(entities, (int)i);
-            Entity *e = &config->entities[i];
-            
-            e->id = (unsigned)cJSON_GetNumberValue(cJSON_GetObjectItem(entity, "id"));
-            
-            cJSON *name = cJSON_GetObjectItem(entity, "name");
-            if (name) {
-                strncpy(e->name, cJSON_GetStringValue(name), sizeof(e->name) - 1);
-            }
-            
-            cJSON *desc = cJSON_GetObjectItem(entity, "description");
-            if (desc) {
-                strncpy(e->description, cJSON_GetStringValue(desc), sizeof(e->description) - 1);
-            }
-            
-            e->level = (unsigned)cJSON_GetNumberValue(cJSON_GetObjectItem(entity, "level"));
-            e->count = (unsigned)cJSON_GetNumberValue(cJSON_GetObjectItem(entity, "count"));
-            
-            // Parse tags array
-            e->tag_count = 0;
-            e->is_enemy = false;
-            e->is_item = false;
-            
-            cJSON *tags = cJSON_GetObjectItem(entity, "tags");
-            if (tags) {
-                int tag_count = cJSON_GetArraySize(tags);
-                for (int j = 0; j < tag_count && e->tag_count < MAX_ENTITY_TAGS; j++) {
-                    cJSON *tag = cJSON_GetArrayItem(tags, j);
-                    const char *tag_str = cJSON_GetStringValue(tag);
-                    if (tag_str && strlen(tag_str) < MAX_TAG_LENGTH) {
-                        strncpy(e->tags[e->tag_count], tag_str, MAX_TAG_LENGTH - 1);
-                        e->tags[e->tag_count][MAX_TAG_LENGTH - 1] = '\0';
-                        
-                        // Set compatibility flags
-                        if (strcmp(tag_str, "enemy") == 0) {
-                            e->is_enemy = true;
-                        } else if (strcmp(tag_str, "item") == 0) {
-                            e->is_item = true;
-                        }
-                        
-                        e->tag_count++;
-                    }
-                }
+    // Enemies act when fought and survived, everything else when claimed
+    e->effects[e->effect_count++] = (Effect){
+        .opcode = (uint8_t)opcode,
+        .flags = (uint8_t)(e->is_enemy || e->level > 0 ? EFFECT_ON_DEFEAT : EFFECT_ON_CLAIM),
+        .argument = (uint16_t)argument,
+    };
+    return true;
+}
+
+// Compiles the effect and group tags. Tags that only describe the entity
+// (enemy, item, onReveal-*, ...) or have no effect yet are skipped.
+static bool config_compile_effects(Entity *e, const Entity *crystals) {
+    for (unsigned i = 0; i < e->tag_count; i++) {
+        const char *tag = e->tags[i];
+        unsigned long n;
+        bool ok = true;
+
+        if (config_tag_number(tag, "heal-", "", &n)) {
+            ok = config_add_effect(e, EFFECT_HEAL, n);
+        } else if (config_tag_number(tag, "reward-experience=", "", &n)) {
+            ok = config_add_effect(e, EFFECT_GAIN_EXPERIENCE, n);
+        } else if (strcmp(tag, "trigger-reveal-random-single") == 0) {
+            ok = config_add_effect(e, EFFECT_REVEAL_RANDOM, 1);
+        } else if (strncmp(tag, "trigger-reveal-square-", 22) == 0) {
+            const char *size = tag + 22;
+            unsigned long width, height;
+            if (!config_scan_number(&size, &width) || *size++ != 'x' ||
+                !config_scan_number(&size, &height) || strcmp(size, "-random") != 0 ||
+                width != height || width % 2 == 0) {
+                fprintf(stderr, "Entity %u: '%s' needs an odd NxN square\n", e->id, tag);
+                return false;
             }
-            
-            // Parse sprite position
-            cJSON *sprites = cJSON_GetObjectItem(entity, "sprites");
-            if (sprites) {
-                cJSON *revealed = cJSON_GetObjectItem(sprites, "revealed");
-                if (revealed) {
-                    e->sprite_pos.x = (unsigned)cJSON_GetNumberValue(cJSON_GetObjectItem(revealed, "x"));
-                    e->sprite_pos.y = (unsigned)cJSON_GetNumberValue(cJSON_GetObjectItem(revealed, "y"));
-                }
+            ok = config_add_effect(e, EFFECT_REVEAL_SQUARE, width);
+        } else if (config_tag_number(tag, "trigger-E", "-reveal", &n)) {
+            if (n >= MAX_ENTITY_GROUPS) {
+                fprintf(stderr, "Entity %u: '%s' names a group over E%d\n", e->id, tag, MAX_ENTITY_GROUPS - 1);
+                return false;
             }
-            
-            // Parse entity transition
-            cJSON *entity_transition = cJSON_GetObjectItem(entity, "entity_transition");
-            if (entity_transition) {
-                cJSON *on_cleared = cJSON_GetObjectItem(entity_transition, "on_cleared");
-                if (on_cleared) {
-                    e->transition.next_entity_id = (unsigned)cJSON_GetNumberValue(cJSON_GetObjectItem(on_cleared, "entity_id"));
-                    
-                    cJSON *sound = cJSON_GetObjectItem(on_cleared, "sound");
-                    if (sound) {
-                        strncpy(e->transition.sound, cJSON_GetStringValue(sound), sizeof(e->transition.sound) - 1);
-                    }
-                }
+            ok = config_add_effect(e, EFFECT_REVEAL_GROUP, n);
+        } else if (strcmp(tag, "trigger-crystals-reveal") == 0) {
+            if (!crystals) {
+                fprintf(stderr, "Entity %u: '%s' needs an entity named %s\n", e->id, tag,
+                        CONFIG_CRYSTALS_NAME);
+                return false;
             }
+            ok = config_add_effect(e, EFFECT_REVEAL_ENTITY, crystals->id);
+        } else if (strcmp(tag, "trigger-win-game") == 0) {
+            ok = config_add_effect(e, EFFECT_WIN_GAME, 0);
+        } else if (config_tag_number(tag, "E", "", &n) && n < MAX_ENTITY_GROUPS) {
+            e->groups |= 1u << n;
+        }
+        if (!ok) {
+            return false;
         }
     }
-    
-    cJSON_Delete(json);
     return true;
 }
 
-bool config_load_solution(SolutionData *solution, const char *solution_file, unsigned solution_index) {
-    char *content = read_file_contents(solution_file);
-    if (!content) {
-        return false;
-    }
-    
-    cJSON *json = cJSON_Parse(content);
-    free(content);
-    
-    if (!json) {
-        fprintf(stderr, "Failed to parse JSON solution\n");
-        return false;
-    }
-    
-    if (!cJSON_IsArray(json)) {
-        fprintf(stderr, "Solution file is not an array\n");
-        cJSON_Delete(json);
-        return false;
-    }
-    
-    int solution_count = cJSON_GetArraySize(json);
-    if ((int)solution_index >= solution_count) {
-        fprintf(stderr, "Solution index %u out of range (0-%d)\n", solution_index, solution_count - 1);
-        cJSON_Delete(json);
-        return false;
-    }
-    
-    cJSON *sol = cJSON_GetArrayItem(json, (int)solution_index);
-    
-    // Parse UUID
-    cJSON *uuid = cJSON_GetObjectItem(sol, "uuid");
-    if (uuid) {
-        strncpy(solution->uuid, cJSON_GetStringValue(uuid), sizeof(solution->uuid) - 1);
-    }
-    
-    // Parse board
-    cJSON *board = cJSON_GetObjectItem(sol, "board");
-    if (!board) {
-        fprintf(stderr, "No board data in solution\n");
-        cJSON_Delete(json);
-        return false;
-    }
-    
-    solution->rows = (unsigned)cJSON_GetArraySize(board);
-    if (solution->rows == 0) {
-        fprintf(stderr, "Empty board in solution\n");
-        cJSON_Delete(json);
-        return false;
-    }
-    
-    cJSON *first_row = cJSON_GetArrayItem(board, 0);
-    solution->cols = (unsigned)cJSON_GetArraySize(first_row);
-    
-    // Allocate 2D array
-    solution->board = malloc(solution->rows * sizeof(unsigned*));
-    for (unsigned i = 0; i < solution->rows; i++) {
-        solution->board[i] = malloc(solution->cols * sizeof(unsigned));
-        
-        cJSON *row = cJSON_GetArrayItem(board, (int)i);
-        for (unsigned j = 0; j < solution->cols; j++) {
-            cJSON *cell = cJSON_GetArrayItem(row, (int)j);
-            solution->board[i][j] = (unsigned)cJSON_GetNumberValue(cell);
+// Builds the ID-indexed lookup table so hot paths never search the entity list
+static bool config_build_lookup(GameConfig *config) {
+    unsigned max_id = 0;
+    for (unsigned i = 0; i < config->entity_count; i++) {
+        if (config->entities[i].id > MAX_ENTITY_ID) {
+            fprintf(stderr, "Entity ID %u exceeds %u\n", config->entities[i].id, MAX_ENTITY_ID);
+            return false;
         }
-    }
-    
-    // Print the solution board
-    printf("Solution board (%ux%u):\n", solution->rows, solution->cols);
-    for (unsigned i = 0; i < solution->rows; i++) {
-        for (unsigned j = 0; j < solution->cols; j++) {
-            printf("%u ", solution->board[i][j]);
+        if (config->entities[i].id > max_id) {
+            max_id = config->entities[i].id;
         }
-        printf("\n");
     }
-    printf("\n");
-    
-    cJSON_Delete(json);
-    return true;
-}
-#endif
 
-void config_free(GameConfig *config) {
-    if (config->entities) {
-        free(config->entities);
-        config->entities = NULL;
+    config->lookup_size = max_id + 1;
+    config->lookup = calloc(config->lookup_size, sizeof(EntityLookup));
+    if (!config->lookup) {
+        fprintf(stderr, "Error in calloc of entity lookup table.\n");
+        return false;
     }
-    config->entity_count = 0;
-}
 
-void config_free_solution(SolutionData *solution) {
-    if (solution->board) {
-        for (unsigned i = 0; i < solution->rows; i++) {
-            free(solution->board[i]);
+    const Entity *crystals = NULL;
+    for (unsigned i = 0; i < config->entity_count; i++) {
+        if (strcmp(config->entities[i].name, CONFIG_CRYSTALS_NAME) == 0) {
+            crystals = &config->entities[i];
         }
-        free(solution->board);
-        solution->board = NULL;
     }
-    solution->rows = 0;
-    solution->cols = 0;
-}
 
-Entity* config_get_entity(const GameConfig *config, unsigned entity_id) {
     for (unsigned i = 0; i < config->entity_count; i++) {
-        if (config->entities[i].id == entity_id) {
-            return &config->entities[i];
+        Entity *e = &config->entities[i];
+        EntityLookup *slot = &config->lookup[e->id];
+        if (slot->entity) {
+            fprintf(stderr, "Duplicate entity ID %u in config\n", e->id);
+            return false;
+        }
+
+        slot->entity = e;
+        slot->threat = e->level;
+        // The entity sheet is laid out 4 sprites per row
+        slot->sprite_index = e->sprite_pos.y * 4 + e->sprite_pos.x;
+        slot->next_entity_id = e->transition.next_entity_id;
+        slot->choices = e->transition.choices.count > 0 ? &e->transition.choices : NULL;
+
+        if (!config_compile_effects(e, crystals)) {
+            return false;
         }
+        slot->groups = e->groups;
+        slot->effects = e->effects;
+        slot->effect_count = e->effect_count;
     }
-    return NULL;
+
+    return true;
 }
 
-unsigned config_count_solutions(const char *solution_file) {
-#ifdef WASM_BUILD
-    char *content = read_file_contents_wasm(solution_file);
+bool config_load(GameConfig *config, const char *config_file) {
+    memset(config, 0, sizeof(*config));
+
+    size_t length = 0;
+    char *content = read_file_contents(config_file, &length);
     if (!content) {
-        printf("WASM: Failed to read solution file for counting\n");
-        return 0;
+        return false;
     }
-    
-    // Count occurrences of "uuid" to count solutions (each solution has one uuid)
-    unsigned count = 0;
-    char *pos = content;
-    while ((pos = strstr(pos, "\"uuid\"")) != NULL) {
-        count++;
-        pos += 6; // Move past "uuid"
+
+    JsonReader reader;
+    json_reader_init(&reader, content, length);
+
+    JsonToken key, value;
+    bool ok = json_reader_next(&reader, &value) &&
+              config_expect(&value, JSON_TOKEN_OBJECT_BEGIN, "<root>");
+    while (ok && json_reader_member(&reader, &key, &value)) {
+        if (json_token_equals(&key, "rows")) {
+            ok = config_read_unsigned(&value, "rows", &config->rows);
+        } else if (json_token_equals(&key, "cols")) {
+            ok = config_read_unsigned(&value, "cols", &config->cols);
+        } else if (json_token_equals(&key, "game_state")) {
+            ok = config_expect(&value, JSON_TOKEN_OBJECT_BEGIN, "game_state") &&
+                 config_parse_game_state(&reader, config);
+        } else if (json_token_equals(&key, "entities")) {
+            ok = config_expect(&value, JSON_TOKEN_ARRAY_BEGIN, "entities") &&
+                 config_parse_entities(&reader, config);
+        } else {
+            ok = json_reader_skip(&reader, &value);
+        }
     }
-    
-    free(content);
-    return count;
-#else
-    char *content = read_file_contents(solution_file);
-    if (!content) {
-        return 0;
+    ok = ok && !json_reader_failed(&reader) &&
+         json_reader_next(&reader, &value) && value.type == JSON_TOKEN_END;
+
+    if (json_reader_failed(&reader)) {
+        json_reader_print_error(&reader, config_file);
     }
-    
-    cJSON *json = cJSON_Parse(content);
     free(content);
-    
-    if (!json) {
-        fprintf(stderr, "Failed to parse JSON solution for counting\n");
-        return 0;
+
+    if (!ok || config->entity_count == 0 || !config_build_lookup(config)) {
+        fprintf(stderr, "Failed to parse config: %s\n", config_file);
+        config_free(config);
+        return false;
     }
-    
-    if (!cJSON_IsArray(json)) {
-        fprintf(stderr, "Solution file is not an array\n");
-        cJSON_Delete(json);
-        return 0;
+
+    LOG_INFO(LOG_CAT_CONFIG, "Loaded config with %u entities, starting level %u, health %u",
+                             config->entity_count, config->starting_level, config->starting_health);
+    return true;
+}
+
+void config_free(GameConfig *config) {
+    if (config->entities) {
+        for (unsigned i = 0; i < config->entity_count; i++) {
+            alias_table_free(&config->entities[i].transition.choices);
+        }
+        free(config->entities);
+        config->entities = NULL;
+    }
+    config->entity_count = 0;
+    if (config->lookup) {
+        free(config->lookup);
+        config->lookup = NULL;
     }
-    
-    int solution_count = cJSON_GetArraySize(json);
-    cJSON_Delete(json);
-    
-    return (unsigned)solution_count;
-#endif
+    config->lookup_size = 0;
 }
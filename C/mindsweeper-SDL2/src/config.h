@@ -2,9 +2,37 @@
 #define CONFIG_H
 
 #include "main.h"
-#ifndef WASM_BUILD
-#include <cjson/cJSON.h>
-#endif
+#include "alias_table.h"
+
+// Entity effects, compiled from tags when the config is loaded so a click
+// runs them through a switch and never looks at the tag strings
+typedef enum {
+    EFFECT_HEAL = 1,            // heal-N: restore N health
+    EFFECT_GAIN_EXPERIENCE,     // reward-experience=N: gain N experience
+    EFFECT_REVEAL_RANDOM,       // trigger-reveal-random-single: reveal N random hidden tiles
+    EFFECT_REVEAL_SQUARE,       // trigger-reveal-square-NxN-random: reveal N x N tiles around a random hidden tile
+    EFFECT_REVEAL_GROUP,        // trigger-EN-reveal: reveal every entity tagged EN
+    EFFECT_REVEAL_ENTITY,       // trigger-crystals-reveal: reveal every tile holding entity N
+    EFFECT_WIN_GAME             // trigger-win-game: claiming it wins the game
+} EffectOpcode;
+
+// When an effect runs
+#define EFFECT_ON_CLAIM 0x1u    // The revealed item or trigger is clicked
+#define EFFECT_ON_DEFEAT 0x2u   // The player fights the enemy and survives
+
+typedef struct {
+    uint8_t opcode;             // EffectOpcode
+    uint8_t flags;              // EFFECT_ON_*
+    uint16_t argument;
+} Effect;
+
+// At most one effect per tag
+#define MAX_ENTITY_EFFECTS MAX_ENTITY_TAGS
+// EN group tags, E0 to E31
+#define MAX_ENTITY_GROUPS 32
+
+// Name of the entity trigger-crystals-reveal uncovers
+#define CONFIG_CRYSTALS_NAME "Crystals"
 
 // Entity data structure
 typedef struct {
@@ -15,9 +43,14 @@ typedef struct {
     unsigned count;
     bool is_enemy;
     bool is_item;
+    bool is_trigger;            // revealed-click-trigger: clicking it runs its effects like an item
+    bool no_experience;         // no-experience: fighting it gives no experience
     bool blocks_input_on_reveal;
     char tags[MAX_ENTITY_TAGS][MAX_TAG_LENGTH];
     unsigned tag_count;
+    uint32_t groups;            // Bit N set by an EN tag
+    Effect effects[MAX_ENTITY_EFFECTS];
+    unsigned effect_count;
     struct {
         unsigned x;
         unsigned y;
@@ -26,10 +59,28 @@ typedef struct {
     // Entity transition data
     struct {
         unsigned next_entity_id;  // Entity ID to transition to when cleared
+        AliasTable choices;       // random_choice outcomes by weight; count 0 for a fixed entity_id
         char sound[MAX_SOUND_NAME];           // Sound effect to play
     } transition;
 } Entity;
 
+// Per-ID data used on the hot paths (threat levels, sprites, transitions),
+// resolved once when the config is loaded.
+typedef struct {
+    Entity *entity;             // NULL when no entity has this ID
+    unsigned threat;            // Added to the threat level of each neighbour
+    unsigned sprite_index;      // Revealed sprite in the entity sheet
+    unsigned next_entity_id;    // on_cleared transition
+    const AliasTable *choices;  // on_cleared random_choice, NULL for a fixed next_entity_id
+    uint32_t groups;            // Bit N set by an EN tag
+    const Effect *effects;
+    unsigned effect_count;
+} EntityLookup;
+
+// Highest entity ID accepted in the config; IDs are stored as uint16 in the
+// solution pack.
+#define MAX_ENTITY_ID 0xffffu
+
 // Game configuration
 typedef struct {
     unsigned rows;
@@ -39,21 +90,23 @@ typedef struct {
     unsigned starting_level;
     Entity *entities;
     unsigned entity_count;
+    EntityLookup *lookup;       // Indexed by entity ID
+    unsigned lookup_size;       // Highest entity ID + 1
 } GameConfig;
 
-// Solution data
-typedef struct {
-    char uuid[MAX_UUID_LENGTH];
-    unsigned **board;  // 2D array of entity IDs
-    unsigned rows;
-    unsigned cols;
-} SolutionData;
-
 bool config_load(GameConfig *config, const char *config_file);
-bool config_load_solution(SolutionData *solution, const char *solution_file, unsigned solution_index);
-unsigned config_count_solutions(const char *solution_file);
 void config_free(GameConfig *config);
-void config_free_solution(SolutionData *solution);
-Entity* config_get_entity(const GameConfig *config, unsigned entity_id);
+
+static inline const EntityLookup* config_lookup(const GameConfig *config, unsigned entity_id) {
+    return entity_id < config->lookup_size ? &config->lookup[entity_id] : NULL;
+}
+
+static inline Entity* config_get_entity(const GameConfig *config, unsigned entity_id) {
+    return entity_id < config->lookup_size ? config->lookup[entity_id].entity : NULL;
+}
+
+static inline unsigned config_entity_threat(const GameConfig *config, unsigned entity_id) {
+    return entity_id < config->lookup_size ? config->lookup[entity_id].threat : 0;
+}
 
 #endif
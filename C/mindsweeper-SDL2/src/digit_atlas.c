@@ -0,0 +1,145 @@
+#include "digit_atlas.h"
+#include <string.h>
+
+// Outline offsets (8-directional, skipping the centre)
+static const int outline_offsets[8][2] = {
+    {-1, -1}, {0, -1}, {1, -1},
+    {-1,  0},          {1,  0},
+    {-1,  1}, {0,  1}, {1,  1}
+};
+
+bool digit_atlas_build(DigitAtlas *atlas, SDL_Renderer *renderer, TTF_Font *font,
+                       SDL_Color fill, SDL_Color outline) {
+    memset(atlas, 0, sizeof(*atlas));
+
+    SDL_Surface *fill_glyphs[10] = {0};
+    SDL_Surface *outline_glyphs[10] = {0};
+    SDL_Surface *sheet = NULL;
+    bool success = false;
+
+    int sheet_w = 0;
+    for (int d = 0; d < 10; d++) {
+        char text[2] = {(char)('0' + d), '\0'};
+        fill_glyphs[d] = TTF_RenderText_Solid(font, text, fill);
+        outline_glyphs[d] = TTF_RenderText_Solid(font, text, outline);
+        if (!fill_glyphs[d] || !outline_glyphs[d]) {
+            fprintf(stderr, "Error rendering digit glyph: %s\n", TTF_GetError());
+            goto cleanup;
+        }
+        if (fill_glyphs[d]->h > atlas->height) {
+            atlas->height = fill_glyphs[d]->h;
+        }
+        sheet_w += fill_glyphs[d]->w + 2;
+    }
+
+    // Outline row on top, fill row below; cells are laid out left to right
+    int outline_h = atlas->height + 2;
+    sheet = SDL_CreateRGBSurfaceWithFormat(0, sheet_w, outline_h * 2, 32, SDL_PIXELFORMAT_RGBA32);
+    if (!sheet) {
+        fprintf(stderr, "Error creating digit atlas surface: %s\n", SDL_GetError());
+        goto cleanup;
+    }
+
+    int x = 0;
+    for (int d = 0; d < 10; d++) {
+        int w = fill_glyphs[d]->w;
+        int h = fill_glyphs[d]->h;
+        atlas->outline[d] = (SDL_Rect){x, 0, w + 2, h + 2};
+        atlas->fill[d] = (SDL_Rect){x + 1, outline_h + 1, w, h};
+
+        for (int i = 0; i < 8; i++) {
+            SDL_Rect dest = {x + 1 + outline_offsets[i][0], 1 + outline_offsets[i][1], w, h};
+            SDL_BlitSurface(outline_glyphs[d], NULL, sheet, &dest);
+        }
+        SDL_Rect dest = atlas->fill[d];
+        SDL_BlitSurface(fill_glyphs[d], NULL, sheet, &dest);
+
+        x += w + 2;
+    }
+
+    atlas->texture = SDL_CreateTextureFromSurface(renderer, sheet);
+    if (!atlas->texture) {
+        fprintf(stderr, "Error creating digit atlas texture: %s\n", SDL_GetError());
+        goto cleanup;
+    }
+    success = true;
+
+cleanup:
+    for (int d = 0; d < 10; d++) {
+        if (fill_glyphs[d]) SDL_FreeSurface(fill_glyphs[d]);
+        if (outline_glyphs[d]) SDL_FreeSurface(outline_glyphs[d]);
+    }
+    if (sheet) SDL_FreeSurface(sheet);
+    return success;
+}
+
+void digit_atlas_free(DigitAtlas *atlas) {
+    if (atlas->texture) {
+        SDL_DestroyTexture(atlas->texture);
+        atlas->texture = NULL;
+    }
+}
+
+// Splits value into its decimal digits, most significant first
+static int digit_atlas_digits(unsigned value, unsigned char digits[10]) {
+    unsigned char reversed[10];
+    int count = 0;
+    do {
+        reversed[count++] = (unsigned char)(value % 10);
+        value /= 10;
+    } while (value > 0);
+
+    for (int i = 0; i < count; i++) {
+        digits[i] = reversed[count - 1 - i];
+    }
+    return count;
+}
+
+int digit_atlas_width(const DigitAtlas *atlas, unsigned value) {
+    unsigned char digits[10];
+    int count = digit_atlas_digits(value, digits);
+
+    int width = 0;
+    for (int i = 0; i < count; i++) {
+        width += atlas->fill[digits[i]].w;
+    }
+    return width;
+}
+
+int digit_atlas_layout(const DigitAtlas *atlas, unsigned value, int x, int y,
+                       SDL_Rect src[DIGIT_ATLAS_MAX_QUADS], SDL_Rect dst[DIGIT_ATLAS_MAX_QUADS]) {
+    unsigned char digits[10];
+    int count = digit_atlas_digits(value, digits);
+    int quads = 0;
+
+    // All outlines first so a neighbouring digit's outline never covers a fill
+    int pen_x = x;
+    for (int i = 0; i < count; i++) {
+        src[quads] = atlas->outline[digits[i]];
+        dst[quads] = (SDL_Rect){pen_x - 1, y - 1, src[quads].w, src[quads].h};
+        pen_x += atlas->fill[digits[i]].w;
+        quads++;
+    }
+
+    pen_x = x;
+    for (int i = 0; i < count; i++) {
+        src[quads] = atlas->fill[digits[i]];
+        dst[quads] = (SDL_Rect){pen_x, y, src[quads].w, src[quads].h};
+        pen_x += src[quads].w;
+        quads++;
+    }
+    return quads;
+}
+
+void digit_atlas_draw(const DigitAtlas *atlas, SDL_Renderer *renderer, unsigned value, int x, int y) {
+    if (!atlas->texture) {
+        return;
+    }
+
+    SDL_Rect src[DIGIT_ATLAS_MAX_QUADS];
+    SDL_Rect dst[DIGIT_ATLAS_MAX_QUADS];
+    int quads = digit_atlas_layout(atlas, value, x, y, src, dst);
+    for (int i = 0; i < quads; i++) {
+        SDL_RenderCopy(renderer, atlas->texture, &src[i], &dst[i]);
+    }
+}
@@ -0,0 +1,32 @@
+#ifndef DIGIT_ATLAS_H
+#define DIGIT_ATLAS_H
+
+#include "main.h"
+
+// Digits 0-9 rendered once into a single texture: the top row holds each
+// digit's outline (the glyph stamped at the 8 surrounding offsets), the bottom
+// row its fill. Drawing a number is then 2 blits per digit with no per-frame
+// surface or texture work.
+#define DIGIT_ATLAS_MAX_QUADS 20    // 2 per digit of a 32-bit unsigned
+
+typedef struct {
+    SDL_Texture *texture;
+    SDL_Rect outline[10];       // Source rects, glyph size + 2 px each way
+    SDL_Rect fill[10];          // Source rects, glyph size
+    int height;                 // Glyph height without outline
+} DigitAtlas;
+
+bool digit_atlas_build(DigitAtlas *atlas, SDL_Renderer *renderer, TTF_Font *font,
+                       SDL_Color fill, SDL_Color outline);
+void digit_atlas_free(DigitAtlas *atlas);
+
+// Width of value's digits laid out as TTF would render the whole number
+int digit_atlas_width(const DigitAtlas *atlas, unsigned value);
+void digit_atlas_draw(const DigitAtlas *atlas, SDL_Renderer *renderer, unsigned value, int x, int y);
+
+// The blits digit_atlas_draw makes, in draw order: every digit's outline,
+// then every fill. Returns the number of quads written to src and dst.
+int digit_atlas_layout(const DigitAtlas *atlas, unsigned value, int x, int y,
+                       SDL_Rect src[DIGIT_ATLAS_MAX_QUADS], SDL_Rect dst[DIGIT_ATLAS_MAX_QUADS]);
+
+#endif
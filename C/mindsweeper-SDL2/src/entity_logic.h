@@ -2,8 +2,10 @@
 #define ENTITY_LOGIC_H
 
 #include "config.h"
+#include "rng.h"
 
-// Entity transition logic
-unsigned choose_random_entity_transition(Entity *entity);
+// Entity an on_cleared transition lands on: one draw from its random_choice
+// table, else its fixed next_entity_id
+unsigned choose_entity_transition(const EntityLookup *lookup, Rng *rng);
 
-#endif 
\ No newline at end of file
+#endif 
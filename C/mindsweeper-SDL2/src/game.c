@@ -3,6 +3,7 @@
 #include "init_sdl.h"
 #include "board_click.h"
 #include "load_media.h"
+#include "log.h"
 
 #ifdef WASM_BUILD
 // Global game pointer for Emscripten main loop
@@ -12,6 +13,7 @@ static struct Game *g_game = NULL;
 bool game_create_string(char **game_str, const char *new_str);
 void game_set_title(struct Game *g);
 bool game_reset(struct Game *g);
+bool game_load_solution(struct Game *g, unsigned solution_index);
 void game_set_scale(struct Game *g);
 void game_toggle_scale(struct Game *g);
 void game_set_theme(struct Game *g, unsigned theme);
@@ -27,18 +29,27 @@ void game_draw(const struct Game *g);
 // Main loop function for Emscripten
 void game_main_loop(void) {
     if (!g_game || !g_game->is_running) {
+        log_flush();
         emscripten_cancel_main_loop();
         return;
     }
 
     if (!game_events(g_game)) {
         g_game->is_running = false;
+        log_flush();
         emscripten_cancel_main_loop();
         return;
     }
 
-    game_draw(g_game);
+    // requestAnimationFrame paces the loop; the canvas keeps the last frame
+    if (g_game->needs_redraw) {
+        game_draw(g_game);
+        g_game->needs_redraw = false;
+    }
     game_update(g_game);
+
+    // No flush thread under WASM: write this frame's log once it is drawn
+    log_flush();
 }
 #endif
 
@@ -51,8 +62,7 @@ bool game_new(struct Game **game) {
     struct Game *g = *game;
 
     g->is_running = true;
-    g->game_over_info.is_game_over = false;  // Initialize game over info
-    g->game_over_info.death_cause[0] = '\0'; // Empty death cause string
+    g->needs_redraw = true;
     g->rows = DEFAULT_BOARD_ROWS;      // Use constant instead of magic number
     g->columns = DEFAULT_BOARD_COLS;   // Use constant instead of magic number
     
@@ -67,24 +77,37 @@ bool game_new(struct Game **game) {
         goto cleanup_failure;
     }
 
-    if (!board_new(&g->board, g->renderer, g->rows, g->columns, g->scale)) {
+    if (!config_load(&g->config, GAME_CONFIG_FILE)) {
+        fprintf(stderr, "Failed to load game config\n");
         goto cleanup_failure;
     }
 
-    // Load solution data
-#ifdef WASM_BUILD
-    if (!board_load_solution(g->board, "latest-s-v0_0_9.json", 0)) {
-#else
-    if (!board_load_solution(g->board, "latest-s-v0_0_9.json", 0)) {
-#endif
-        fprintf(stderr, "Failed to load solution data\n");
+    if (!game_state_init(&g->state, &g->config, g->rows, g->columns)) {
         goto cleanup_failure;
     }
 
-    // Initialize admin panel with solution count
-    g->admin.total_solutions = config_count_solutions("latest-s-v0_0_9.json");
-    g->admin.current_solution_index = 0;
-    printf("Total solutions available: %u\n", g->admin.total_solutions);
+    // One seed replays the whole session: every game seed is drawn from it
+    const char *seed_str = getenv("MINDSWEEPER_SEED");
+    g->session_seed = seed_str ? strtoull(seed_str, NULL, 0) : rng_entropy_seed();
+    rng_seed(&g->rng, g->session_seed, 0);
+    game_state_seed(&g->state, rng_next64(&g->rng));
+    LOG_INFO(LOG_CAT_GAME, "Session seed: %llu", (unsigned long long)g->session_seed);
+
+    if (!board_new(&g->board, g->renderer, &g->state, g->scale)) {
+        goto cleanup_failure;
+    }
+
+    // Index the solution pack once; count, UUIDs and boards come from it
+    // for the rest of the game.
+    if (!solution_catalog_open(&g->solutions, SOLUTION_PACK_FILE)) {
+        goto cleanup_failure;
+    }
+    LOG_INFO(LOG_CAT_GAME, "Total solutions available: %u", solution_catalog_count(&g->solutions));
+
+    if (!game_load_solution(g, 0)) {
+        fprintf(stderr, "Failed to load solution data\n");
+        goto cleanup_failure;
+    }
 
     if (!clock_new(&g->clock, g->renderer, g->columns, g->scale)) {
         goto cleanup_failure;
@@ -98,6 +121,10 @@ bool game_new(struct Game **game) {
         goto cleanup_failure;
     }
 
+    if (!text_cache_new(&g->text_cache, g->renderer)) {
+        goto cleanup_failure;
+    }
+
     if (!game_create_string(&g->size_str, "MindSweeper")) {
         goto cleanup_failure;
     }
@@ -124,6 +151,9 @@ void game_free(struct Game **game) {
 
         border_free(&g->border);
         board_free(&g->board);
+        game_state_free(&g->state);
+        config_free(&g->config);
+        solution_catalog_close(&g->solutions);
         clock_free(&g->clock);
         face_free(&g->face);
         player_panel_free(&g->player_panel);
@@ -134,6 +164,7 @@ void game_free(struct Game **game) {
         }
         
         // Clean up screen system resources
+        text_cache_free(&g->text_cache);
         if (g->info_font) {
             TTF_CloseFont(g->info_font);
             g->info_font = NULL;
@@ -156,7 +187,7 @@ void game_free(struct Game **game) {
         free(*game);
         *game = NULL;
 
-        printf("all clean!\n");
+        LOG_DEBUG(LOG_CAT_GAME, "all clean!");
     }
 }
 
@@ -190,13 +221,22 @@ void game_set_title(struct Game *g) {
     free(title);
 }
 
+// Loads the solution into the game state and resyncs the board with it
+bool game_load_solution(struct Game *g, unsigned solution_index) {
+    if (!game_state_load(&g->state, &g->solutions, solution_index)) {
+        return false;
+    }
+    board_sync_tiles(g->board);
+    return true;
+}
+
 bool game_reset(struct Game *g) {
     // Pick a random solution index (excluding the current one for variety)
     unsigned new_solution_index;
     if (g->admin.total_solutions > 1) {
         // If we have multiple solutions, pick a different one
         do {
-            new_solution_index = (unsigned)(rand() % g->admin.total_solutions);
+            new_solution_index = rng_below(&g->rng, g->admin.total_solutions);
         } while (new_solution_index == g->admin.current_solution_index && g->admin.total_solutions > 1);
     } else {
         // If only one solution or no solutions, use index 0
@@ -204,21 +244,22 @@ bool game_reset(struct Game *g) {
     }
     
     // Load the new solution
-    if (!board_load_solution(g->board, "latest-s-v0_0_9.json", new_solution_index)) {
+    if (!game_load_solution(g, new_solution_index)) {
         fprintf(stderr, "Failed to load random solution %u during reset\n", new_solution_index);
-        // Fallback to regular reset if loading fails
-        if (!board_reset(g->board)) {
-            return false;
-        }
+        // Fallback to an empty board if loading fails
+        game_state_clear(&g->state);
+        board_sync_tiles(g->board);
     } else {
         g->admin.current_solution_index = new_solution_index;
-        printf("Reset: Loaded random solution %u\n", new_solution_index);
+        LOG_INFO(LOG_CAT_GAME, "Reset: Loaded random solution %u", new_solution_index);
     }
 
+    game_state_seed(&g->state, rng_next64(&g->rng));
+    LOG_INFO(LOG_CAT_GAME, "Game seed: %llu", (unsigned long long)g->state.seed);
+
     clock_reset(g->clock);
     face_default(g->face);
-    g->game_over_info.is_game_over = false;  // Reset game over state
-    g->game_over_info.death_cause[0] = '\0'; // Clear death cause
+    game_state_reset_game_over(&g->state);
 
     return true;
 }
@@ -235,6 +276,7 @@ void game_set_scale(struct Game *g) {
     
     // Update info font size
     if (g->info_font) {
+        text_cache_invalidate_font(g->text_cache, g->info_font);
         TTF_CloseFont(g->info_font);
         g->info_font = TTF_OpenFont("images/m6x11.ttf", 14 * g->scale);
     }
@@ -259,7 +301,10 @@ bool game_set_size(struct Game *g, unsigned rows, unsigned columns, int scale,
     g->scale = scale;
 
     border_set_size(g->border, g->rows, g->columns);
-    board_set_size(g->board, g->rows, g->columns);
+    if (!game_state_resize(&g->state, g->rows, g->columns) ||
+        !board_set_size(g->board, g->rows, g->columns)) {
+        return false;
+    }
     face_set_size(g->face, g->columns);
     player_panel_set_size(g->player_panel, g->columns);
 
@@ -296,7 +341,7 @@ bool game_mouse_up(struct Game *g, int x, int y, Uint8 button) {
     }
     
     // Ignore board interactions during game over
-    if (g->game_over_info.is_game_over) {
+    if (g->state.game_over.is_game_over) {
         return true;
     }
     
@@ -327,10 +372,19 @@ bool game_mouse_up(struct Game *g, int x, int y, Uint8 button) {
 
 bool game_events(struct Game *g) {
     while (SDL_PollEvent(&g->event)) {
+        // Nothing on screen follows the pointer
+        if (g->event.type != SDL_MOUSEMOTION) {
+            g->needs_redraw = true;
+        }
+
         switch (g->event.type) {
         case SDL_QUIT:
             g->is_running = false;
             break;
+        case SDL_RENDER_TARGETS_RESET:
+            // Render target contents were lost, e.g. on a Direct3D device reset
+            board_invalidate_layer(g->board);
+            break;
         case SDL_MOUSEBUTTONDOWN:
             game_mouse_down(g, g->event.button.x, g->event.button.y,
                             g->event.button.button);
@@ -344,7 +398,7 @@ bool game_events(struct Game *g) {
         case SDL_KEYDOWN:
             switch (g->event.key.keysym.scancode) {
             case SDL_SCANCODE_SPACE:
-                if (g->game_over_info.is_game_over) {
+                if (g->state.game_over.is_game_over) {
                     game_reset_game_over(g);
                 } else {
                     if (!game_reset(g))
@@ -392,16 +446,16 @@ bool game_events(struct Game *g) {
                 break;
             case SDL_SCANCODE_F4:
                 if (!game_admin_load_map(g, g->admin.current_solution_index + 1)) {
-                    printf("Failed to load next map\n");
+                    LOG_WARN(LOG_CAT_ADMIN, "Failed to load next map");
                 }
                 break;
             case SDL_SCANCODE_F5:
                 if (g->admin.current_solution_index > 0) {
                     if (!game_admin_load_map(g, g->admin.current_solution_index - 1)) {
-                        printf("Failed to load previous map\n");
+                        LOG_WARN(LOG_CAT_ADMIN, "Failed to load previous map");
                     }
                 } else {
-                    printf("Already at first map (0)\n");
+                    LOG_INFO(LOG_CAT_ADMIN, "Already at first map (0)");
                 }
                 break;
             case SDL_SCANCODE_F12:
@@ -441,14 +495,23 @@ bool game_events(struct Game *g) {
 }
 
 void game_update(struct Game *g) {
-    // Update board animations
+    // Animating tiles change every frame, up to and including the frame
+    // their animation finishes in
+    if (board_has_animations(g->board)) {
+        g->needs_redraw = true;
+    }
+
+    // Apply entity changes that are due, then update board animations
+    if (game_state_advance(&g->state, SDL_GetTicks()) > 0) {
+        g->needs_redraw = true;
+    }
     board_update_animations(g->board);
     
     // Update other game systems
     clock_update(g->clock);
     
     // Check if player can level up
-    g->player_panel->can_level_up = (g->player.experience >= g->player.exp_to_next_level);
+    g->player_panel->can_level_up = game_state_can_level_up(&g->state);
 }
 
 void game_draw(const struct Game *g) {
@@ -458,27 +521,22 @@ void game_draw(const struct Game *g) {
     switch (g->current_screen) {
         case SCREEN_GAME:
             board_draw(g->board);
-            player_panel_draw(g->player_panel, &g->player);
+            player_panel_draw(g->player_panel, &g->state.player);
             
             // Draw keyboard shortcuts hint
             if (g->info_font) {
                 SDL_Color grey = {150, 150, 150, 255};
                 const char *hint = "Press H for Help, E for Entities";
                 
-                SDL_Surface *hint_surface = TTF_RenderText_Solid(g->info_font, hint, grey);
-                if (hint_surface) {
-                    SDL_Texture *hint_texture = SDL_CreateTextureFromSurface(g->renderer, hint_surface);
-                    if (hint_texture) {
-                        SDL_Rect hint_rect = {
-                            (WINDOW_WIDTH * g->scale) - hint_surface->w - (5 * g->scale),
-                            (WINDOW_HEIGHT * g->scale) - hint_surface->h - (5 * g->scale),
-                            hint_surface->w,
-                            hint_surface->h
-                        };
-                        SDL_RenderCopy(g->renderer, hint_texture, NULL, &hint_rect);
-                        SDL_DestroyTexture(hint_texture);
-                    }
-                    SDL_FreeSurface(hint_surface);
+                const TextCacheEntry *hint_text = text_cache_get(g->text_cache, g->info_font, hint, grey);
+                if (hint_text) {
+                    SDL_Rect hint_rect = {
+                        (WINDOW_WIDTH * g->scale) - hint_text->w - (5 * g->scale),
+                        (WINDOW_HEIGHT * g->scale) - hint_text->h - (5 * g->scale),
+                        hint_text->w,
+                        hint_text->h
+                    };
+                    SDL_RenderCopy(g->renderer, hint_text->texture, NULL, &hint_rect);
                 }
             }
             
@@ -498,6 +556,28 @@ void game_draw(const struct Game *g) {
     SDL_RenderPresent(g->renderer);
 }
 
+#ifndef WASM_BUILD
+// Milliseconds the loop may sleep before it has work to do, or -1 to sleep
+// until input. A pending frame is due at next_frame, or straight away with
+// vsync since SDL_RenderPresent then does the waiting. An idle game only
+// wakes for its next entity change; the clock is never drawn, so its ticks
+// need no wakeup.
+static int game_idle_timeout(const struct Game *g, Uint32 next_frame) {
+    Uint32 now = SDL_GetTicks();
+    if (g->needs_redraw || board_has_animations(g->board)) {
+        if (g->vsync || SDL_TICKS_PASSED(now, next_frame)) {
+            return 0;
+        }
+        return (int)(next_frame - now);
+    }
+    if (game_state_has_pending(&g->state)) {
+        Uint32 due = game_state_next_due(&g->state);
+        return SDL_TICKS_PASSED(now, due) ? 0 : (int)(due - now);
+    }
+    return -1;
+}
+#endif
+
 bool game_run(struct Game *g) {
 #ifdef WASM_BUILD
     // Set global game pointer for Emscripten main loop
@@ -509,16 +589,25 @@ bool game_run(struct Game *g) {
     
     return true;
 #else
-    // Traditional game loop for native builds
+    // Frames are only drawn when something changed. In between, the loop
+    // sleeps in SDL_WaitEventTimeout until input arrives or the next deadline.
+    Uint32 next_frame = SDL_GetTicks();
     while (g->is_running) {
+        int timeout = game_idle_timeout(g, next_frame);
+        if (timeout != 0) {
+            SDL_WaitEventTimeout(NULL, timeout);
+        }
+
         if (!game_events(g)) {
             return false;
         }
 
-        game_draw(g);
+        if (g->needs_redraw) {
+            next_frame = SDL_GetTicks() + GAME_FRAME_MS;
+            game_draw(g);
+            g->needs_redraw = false;
+        }
         game_update(g);
-
-        SDL_Delay(16);
     }
 
     return true;
@@ -548,8 +637,8 @@ int calculate_optimal_scale(int window_width, int window_height, int board_rows,
     if (optimal_scale < 1) optimal_scale = 1;
     if (optimal_scale > 8) optimal_scale = 8;  // Cap at 8x for performance
     
-    printf("Window: %dx%d, Available: %dx%d, Calculated scale: %d\n", 
-           window_width, window_height, available_width, available_height, optimal_scale);
+    LOG_INFO(LOG_CAT_GAME, "Window: %dx%d, Available: %dx%d, Calculated scale: %d", 
+                           window_width, window_height, available_width, available_height, optimal_scale);
     
     return optimal_scale;
 }
@@ -557,73 +646,13 @@ int calculate_optimal_scale(int window_width, int window_height, int board_rows,
 // ========== PLAYER STATS FUNCTIONS ==========
 
 void game_init_player_stats(struct Game *g) {
-    // Get starting level from config
-    const GameConfig *config = board_get_config();
-    unsigned starting_level = (config && config->starting_level > 0) ? config->starting_level : 1;
-    
-    g->player.level = starting_level;
-    g->player.max_health = game_calculate_max_health(g->player.level);
-    g->player.health = g->player.max_health;
-    g->player.experience = 0;
-    g->player.exp_to_next_level = game_calculate_exp_requirement(g->player.level);
+    game_state_init_player(&g->state);
     
     // Initialize admin panel
     g->admin.god_mode_enabled = false;
     g->admin.admin_panel_visible = false;
     g->admin.current_solution_index = 0;
-    g->admin.total_solutions = 1; // Will be updated when available
-    
-    printf("Player initialized: Level %u, Health %u/%u, Exp %u/%u\n", 
-           g->player.level, g->player.health, g->player.max_health,
-           g->player.experience, g->player.exp_to_next_level);
-}
-
-void game_update_player_health(struct Game *g, int health_change) {
-    if (health_change < 0) {
-        unsigned damage = (unsigned)(-health_change);
-        if (damage >= g->player.health) {
-            g->player.health = 0;
-        } else {
-            g->player.health -= damage;
-        }
-    } else {
-        g->player.health += (unsigned)health_change;
-        if (g->player.health > g->player.max_health) {
-            g->player.health = g->player.max_health;
-        }
-    }
-    
-    printf("Player health: %u/%u\n", g->player.health, g->player.max_health);
-    
-    // Removed automatic game over check - will be handled explicitly in combat
-}
-
-void game_level_up_player(struct Game *g) {
-    // Handle multiple level-ups if player has gained enough experience
-    while (g->player.experience >= g->player.exp_to_next_level) {
-        // Calculate excess experience that carries over to next level
-        unsigned excess_exp = g->player.experience - g->player.exp_to_next_level;
-        
-        g->player.level++;
-        g->player.experience = excess_exp;  // Carry over excess experience
-        g->player.max_health = game_calculate_max_health(g->player.level);
-        g->player.health = g->player.max_health; // Full heal on level up
-        g->player.exp_to_next_level = game_calculate_exp_requirement(g->player.level);
-        
-        printf("LEVEL UP! Player is now level %u with %u health (excess exp: %u)\n", 
-               g->player.level, g->player.max_health, excess_exp);
-    }
-}
-
-unsigned game_calculate_max_health(unsigned level) {
-    if (level >= GOD_MODE_LEVEL) {
-        return GOD_MODE_HEALTH; // GOD mode health
-    }
-    return BASE_HEALTH + (level * HEALTH_PER_LEVEL); // Base health + 2 per level
-}
-
-unsigned game_calculate_exp_requirement(unsigned level) {
-    return level * EXP_PER_LEVEL_MULTIPLIER; // Simple exp curve: 5, 10, 15, 20, etc.
+    g->admin.total_solutions = solution_catalog_count(&g->solutions);
 }
 
 // ========== ADMIN PANEL FUNCTIONS ==========
@@ -635,9 +664,11 @@ void game_toggle_admin_panel(struct Game *g) {
         printf("\n=== ADMIN PANEL ACTIVATED ===\n");
         game_print_admin_help();
         printf("Current Player Stats: Level %u, Health %u/%u\n", 
-               g->player.level, g->player.health, g->player.max_health);
+               g->state.player.level, g->state.player.health, g->state.player.max_health);
         printf("GOD Mode: %s\n", g->admin.god_mode_enabled ? "ENABLED" : "DISABLED");
         printf("Current Map: %u\n", g->admin.current_solution_index);
+        printf("Game Seed: %llu (session %llu)\n", (unsigned long long)g->state.seed,
+               (unsigned long long)g->session_seed);
     } else {
         printf("=== ADMIN PANEL DEACTIVATED ===\n");
     }
@@ -647,39 +678,30 @@ void game_admin_god_mode(struct Game *g) {
     g->admin.god_mode_enabled = !g->admin.god_mode_enabled;
     
     if (g->admin.god_mode_enabled) {
-        g->game_over_info.is_game_over = false;  // Reset game over state when entering god mode
-        g->game_over_info.death_cause[0] = '\0'; // Clear death cause
-        g->player.level = GOD_MODE_LEVEL;
-        g->player.max_health = game_calculate_max_health(g->player.level);
-        g->player.health = g->player.max_health;
-        g->player.experience = 0;
-        g->player.exp_to_next_level = game_calculate_exp_requirement(g->player.level);
+        game_state_reset_game_over(&g->state); // Reset game over state when entering god mode
+        game_state_set_player_level(&g->state, GOD_MODE_LEVEL);
         
-        printf("🔱 GOD MODE ACTIVATED! Player level set to %u with %u health!\n", 
-               GOD_MODE_LEVEL, GOD_MODE_HEALTH);
+        LOG_INFO(LOG_CAT_ADMIN, "🔱 GOD MODE ACTIVATED! Player level set to %u with %u health!", 
+                                GOD_MODE_LEVEL, GOD_MODE_HEALTH);
         face_won(g->face); // Show winning face for GOD mode
     } else {
-        g->player.level = 1;
-        g->player.max_health = game_calculate_max_health(g->player.level);
-        g->player.health = g->player.max_health;
-        g->player.experience = 0;
-        g->player.exp_to_next_level = game_calculate_exp_requirement(g->player.level);
+        game_state_set_player_level(&g->state, 1);
         
-        printf("GOD MODE DEACTIVATED. Player reset to level 1.\n");
+        LOG_INFO(LOG_CAT_ADMIN, "GOD MODE DEACTIVATED. Player reset to level 1.");
         face_default(g->face);
     }
 }
 
 void game_admin_reveal_all(struct Game *g) {
-    printf("🔍 REVEALING ALL TILES...\n");
+    LOG_INFO(LOG_CAT_ADMIN, "🔍 REVEALING ALL TILES...");
     board_reveal_all_tiles(g->board);
-    printf("All tiles revealed!\n");
+    LOG_INFO(LOG_CAT_ADMIN, "All tiles revealed!");
 }
 
 bool game_admin_load_map(struct Game *g, unsigned solution_index) {
-    printf("📍 Loading map %u...\n", solution_index);
+    LOG_INFO(LOG_CAT_ADMIN, "📍 Loading map %u...", solution_index);
     
-    if (board_load_solution(g->board, "latest-s-v0_0_9.json", solution_index)) {
+    if (game_load_solution(g, solution_index)) {
         g->admin.current_solution_index = solution_index;
         
         // Reset game state for new map
@@ -687,10 +709,10 @@ bool game_admin_load_map(struct Game *g, unsigned solution_index) {
             return false;
         }
         
-        printf("✅ Successfully loaded map %u\n", solution_index);
+        LOG_INFO(LOG_CAT_ADMIN, "✅ Successfully loaded map %u", solution_index);
         return true;
     } else {
-        printf("❌ Failed to load map %u\n", solution_index);
+        LOG_WARN(LOG_CAT_ADMIN, "❌ Failed to load map %u", solution_index);
         return false;
     }
 }
@@ -713,29 +735,27 @@ void game_check_game_over(struct Game *g) {
         return;
     }
     
-    if (g->player.health <= 0 && !g->game_over_info.is_game_over) {
+    if (g->state.player.health == 0 && !g->state.game_over.is_game_over) {
         game_set_game_over(g, "Unknown"); // Default death cause if not specified
     }
 }
 
 void game_set_game_over(struct Game *g, const char *entity_name) {
-    g->game_over_info.is_game_over = true;
-    
-    // Copy the entity name safely
-    if (entity_name) {
-        strncpy(g->game_over_info.death_cause, entity_name, MAX_ENTITY_NAME - 1);
-        g->game_over_info.death_cause[MAX_ENTITY_NAME - 1] = '\0'; // Ensure null termination
+    game_state_set_game_over(&g->state, entity_name);
+    game_show_game_over(g);
+}
+
+void game_show_game_over(struct Game *g) {
+    LOG_INFO(LOG_CAT_GAME, "Press SPACE to restart.");
+    if (g->state.game_over.is_won) {
+        face_won(g->face);
     } else {
-        strcpy(g->game_over_info.death_cause, "Unknown");
+        face_lost(g->face);  // Set sad face
     }
-    
-    printf("=== GAME OVER ===\n");
-    printf("Death by %s! Press SPACE to restart.\n", g->game_over_info.death_cause);
-    face_lost(g->face);  // Set sad face
 }
 
 void game_draw_game_over_popup(const struct Game *g) {
-    if (!g->game_over_info.is_game_over) {
+    if (!g->state.game_over.is_game_over) {
         return;
     }
     
@@ -784,15 +804,22 @@ void game_draw_game_over_popup(const struct Game *g) {
         int text_x = popup_x + 10 * g->scale;
         int text_y = popup_y + 8 * g->scale;
         
-        // Draw "GAME OVER" text
-        player_panel_draw_text(g->player_panel, "GAME OVER", 
-                              text_x, text_y, red);
-        
-        // Draw death cause message
-        char death_message[128];
-        snprintf(death_message, sizeof(death_message), "Death by %s", g->game_over_info.death_cause);
-        player_panel_draw_text(g->player_panel, death_message, 
-                              text_x, text_y + 18 * g->scale, black);
+        if (g->state.game_over.is_won) {
+            SDL_Color green = {0, 120, 0, 255};
+            player_panel_draw_text(g->player_panel, "VICTORY", text_x, text_y, green);
+            player_panel_draw_text(g->player_panel, "The quest is complete",
+                                  text_x, text_y + 18 * g->scale, black);
+        } else {
+            // Draw "GAME OVER" text
+            player_panel_draw_text(g->player_panel, "GAME OVER", 
+                                  text_x, text_y, red);
+            
+            // Draw death cause message
+            char death_message[128];
+            snprintf(death_message, sizeof(death_message), "Death by %s", g->state.game_over.death_cause);
+            player_panel_draw_text(g->player_panel, death_message, 
+                                  text_x, text_y + 18 * g->scale, black);
+        }
         
         // Draw restart instruction
         player_panel_draw_text(g->player_panel, "Press SPACE to restart", 
@@ -804,18 +831,17 @@ void game_draw_game_over_popup(const struct Game *g) {
 }
 
 void game_reset_game_over(struct Game *g) {
-    g->game_over_info.is_game_over = false;
-    g->game_over_info.death_cause[0] = '\0'; // Clear death cause
+    game_state_reset_game_over(&g->state);
     
     // Reset player stats
     game_init_player_stats(g);
     
     // Reset game board
     if (!game_reset(g)) {
-        printf("Warning: Failed to reset game board\n");
+        LOG_WARN(LOG_CAT_GAME, "Failed to reset game board");
     }
     
-    printf("Game restarted!\n");
+    LOG_INFO(LOG_CAT_GAME, "Game restarted!");
 }
 
 // ========== PLAYER PANEL FUNCTIONS ==========
@@ -848,6 +874,10 @@ bool player_panel_new(PlayerPanel **panel, SDL_Renderer *renderer, unsigned colu
         return false;
     }
 
+    if (!text_cache_new(&p->text_cache, p->renderer)) {
+        return false;
+    }
+
     player_panel_set_scale(p, p->scale);
 
     return true;
@@ -867,6 +897,8 @@ void player_panel_free(PlayerPanel **panel) {
             p->sprite_sheet = NULL;
         }
 
+        text_cache_free(&p->text_cache);
+
         if (p->font) {
             TTF_CloseFont(p->font);
             p->font = NULL;
@@ -877,7 +909,7 @@ void player_panel_free(PlayerPanel **panel) {
         free(*panel);
         *panel = NULL;
         
-        printf("player panel clean.\n");
+        LOG_DEBUG(LOG_CAT_GAME, "player panel clean.");
     }
 }
 
@@ -1061,28 +1093,7 @@ void player_panel_draw_text(const PlayerPanel *p, const char *text, int x, int y
         return;
     }
     
-    SDL_Surface *text_surface = TTF_RenderText_Solid(p->font, text, color);
-    if (!text_surface) {
-        return;
-    }
-    
-    SDL_Texture *text_texture = SDL_CreateTextureFromSurface(p->renderer, text_surface);
-    if (!text_texture) {
-        SDL_FreeSurface(text_surface);
-        return;
-    }
-    
-    SDL_Rect dest_rect = {
-        x,
-        y,
-        text_surface->w,
-        text_surface->h
-    };
-    
-    SDL_RenderCopy(p->renderer, text_texture, NULL, &dest_rect);
-    
-    SDL_DestroyTexture(text_texture);
-    SDL_FreeSurface(text_surface);
+    text_cache_draw(p->text_cache, p->font, text, color, x, y);
 }
 
 bool player_panel_handle_click(PlayerPanel *p, int x, int y, struct Game *g) {
@@ -1091,8 +1102,8 @@ bool player_panel_handle_click(PlayerPanel *p, int x, int y, struct Game *g) {
         x >= p->level_up_button.x && x < p->level_up_button.x + p->level_up_button.w &&
         y >= p->level_up_button.y && y < p->level_up_button.y + p->level_up_button.h) {
         
-        printf("Level-up button clicked!\n");
-        game_level_up_player(g);
+        LOG_DEBUG(LOG_CAT_CLICK, "Level-up button clicked!");
+        game_state_level_up(&g->state);
         return true;
     }
     
@@ -1116,7 +1127,7 @@ void game_init_screen_system(struct Game *g) {
 
 void game_set_screen(struct Game *g, UIScreenState screen) {
     g->current_screen = screen;
-    printf("Switched to screen: %d\n", screen);
+    LOG_DEBUG(LOG_CAT_GAME, "Switched to screen: %d", screen);
 }
 
 void game_setup_screen_buttons(struct Game *g) {
@@ -1206,38 +1217,14 @@ void game_draw_screen_buttons(const struct Game *g) {
             SDL_Color black = {0, 0, 0, 255};
             
             // Entities button text
-            SDL_Surface *entities_surface = TTF_RenderText_Solid(g->info_font, "Entities", black);
-            if (entities_surface) {
-                SDL_Texture *entities_texture = SDL_CreateTextureFromSurface(g->renderer, entities_surface);
-                if (entities_texture) {
-                    SDL_Rect text_rect = {
-                        g->screen_buttons.entities_button.x + 10 * g->scale,
-                        g->screen_buttons.entities_button.y + 5 * g->scale,
-                        entities_surface->w,
-                        entities_surface->h
-                    };
-                    SDL_RenderCopy(g->renderer, entities_texture, NULL, &text_rect);
-                    SDL_DestroyTexture(entities_texture);
-                }
-                SDL_FreeSurface(entities_surface);
-            }
+            text_cache_draw(g->text_cache, g->info_font, "Entities", black,
+                            g->screen_buttons.entities_button.x + 10 * g->scale,
+                            g->screen_buttons.entities_button.y + 5 * g->scale);
             
             // How to Play button text
-            SDL_Surface *howto_surface = TTF_RenderText_Solid(g->info_font, "How to Play", black);
-            if (howto_surface) {
-                SDL_Texture *howto_texture = SDL_CreateTextureFromSurface(g->renderer, howto_surface);
-                if (howto_texture) {
-                    SDL_Rect text_rect = {
-                        g->screen_buttons.howto_button.x + 5 * g->scale,
-                        g->screen_buttons.howto_button.y + 5 * g->scale,
-                        howto_surface->w,
-                        howto_surface->h
-                    };
-                    SDL_RenderCopy(g->renderer, howto_texture, NULL, &text_rect);
-                    SDL_DestroyTexture(howto_texture);
-                }
-                SDL_FreeSurface(howto_surface);
-            }
+            text_cache_draw(g->text_cache, g->info_font, "How to Play", black,
+                            g->screen_buttons.howto_button.x + 5 * g->scale,
+                            g->screen_buttons.howto_button.y + 5 * g->scale);
         }
     } else {
         // Draw Back button on info screens
@@ -1249,21 +1236,9 @@ void game_draw_screen_buttons(const struct Game *g) {
         // Back button text
         if (g->info_font) {
             SDL_Color black = {0, 0, 0, 255};
-            SDL_Surface *back_surface = TTF_RenderText_Solid(g->info_font, "Back", black);
-            if (back_surface) {
-                SDL_Texture *back_texture = SDL_CreateTextureFromSurface(g->renderer, back_surface);
-                if (back_texture) {
-                    SDL_Rect text_rect = {
-                        g->screen_buttons.back_button.x + 20 * g->scale,
-                        g->screen_buttons.back_button.y + 5 * g->scale,
-                        back_surface->w,
-                        back_surface->h
-                    };
-                    SDL_RenderCopy(g->renderer, back_texture, NULL, &text_rect);
-                    SDL_DestroyTexture(back_texture);
-                }
-                SDL_FreeSurface(back_surface);
-            }
+            text_cache_draw(g->text_cache, g->info_font, "Back", black,
+                            g->screen_buttons.back_button.x + 20 * g->scale,
+                            g->screen_buttons.back_button.y + 5 * g->scale);
         }
     }
 }
@@ -1278,8 +1253,8 @@ void game_draw_entities_screen(const struct Game *g) {
         return; // Can't draw text without font
     }
     
-    const GameConfig *config = board_get_config();
-    if (!config || config->entity_count == 0) {
+    const GameConfig *config = &g->config;
+    if (config->entity_count == 0) {
         return;
     }
     
@@ -1295,16 +1270,8 @@ void game_draw_entities_screen(const struct Game *g) {
     int current_y = start_y;
     
     // Title
-    SDL_Surface *title_surface = TTF_RenderText_Solid(g->info_font, "ENTITIES", yellow);
-    if (title_surface) {
-        SDL_Texture *title_texture = SDL_CreateTextureFromSurface(g->renderer, title_surface);
-        if (title_texture) {
-            SDL_Rect title_rect = {start_x, 20 * g->scale, title_surface->w, title_surface->h};
-            SDL_RenderCopy(g->renderer, title_texture, NULL, &title_rect);
-            SDL_DestroyTexture(title_texture);
-        }
-        SDL_FreeSurface(title_surface);
-    }
+    text_cache_draw(g->text_cache, g->info_font, "ENTITIES", yellow,
+                    start_x, 20 * g->scale);
     
     // Category headers
     current_y += line_height;
@@ -1318,16 +1285,8 @@ void game_draw_entities_screen(const struct Game *g) {
     
     for (int cat = 0; cat < 3; cat++) {
         // Draw category title
-        SDL_Surface *cat_surface = TTF_RenderText_Solid(g->info_font, categories[cat].title, categories[cat].color);
-        if (cat_surface) {
-            SDL_Texture *cat_texture = SDL_CreateTextureFromSurface(g->renderer, cat_surface);
-            if (cat_texture) {
-                SDL_Rect cat_rect = {start_x, current_y, cat_surface->w, cat_surface->h};
-                SDL_RenderCopy(g->renderer, cat_texture, NULL, &cat_rect);
-                SDL_DestroyTexture(cat_texture);
-            }
-            SDL_FreeSurface(cat_surface);
-        }
+        text_cache_draw(g->text_cache, g->info_font, categories[cat].title, categories[cat].color,
+                        start_x, current_y);
         current_y += line_height;
         
         // Draw entities in this category
@@ -1349,10 +1308,10 @@ void game_draw_entities_screen(const struct Game *g) {
                 
                 for (unsigned r = 0; r < g->board->rows; r++) {
                     for (unsigned c = 0; c < g->board->columns; c++) {
-                        unsigned board_entity_id = board_get_entity_id(g->board, r, c);
+                        unsigned board_entity_id = game_state_entity_id(&g->state, r, c);
                         if (board_entity_id == entity->id) {
                             remaining_count++;
-                            TileState state = board_get_tile_state(g->board, r, c);
+                            TileState state = game_state_tile_state(&g->state, r, c);
                             if (state == TILE_REVEALED) {
                                 revealed_count++;
                             }
@@ -1368,16 +1327,8 @@ void game_draw_entities_screen(const struct Game *g) {
                         (int)(25 - strlen(entity->name)), "", // Right-align counts
                         revealed_count, remaining_count);
                 
-                SDL_Surface *entity_surface = TTF_RenderText_Solid(g->info_font, entity_line, white);
-                if (entity_surface) {
-                    SDL_Texture *entity_texture = SDL_CreateTextureFromSurface(g->renderer, entity_surface);
-                    if (entity_texture) {
-                        SDL_Rect entity_rect = {start_x, current_y, entity_surface->w, entity_surface->h};
-                        SDL_RenderCopy(g->renderer, entity_texture, NULL, &entity_rect);
-                        SDL_DestroyTexture(entity_texture);
-                    }
-                    SDL_FreeSurface(entity_surface);
-                }
+                text_cache_draw(g->text_cache, g->info_font, entity_line, white,
+                                start_x, current_y);
                 current_y += line_height;
                 
                 // Check if we're running out of space
@@ -1412,16 +1363,8 @@ void game_draw_howto_screen(const struct Game *g) {
     int max_width = (WINDOW_WIDTH - 20) * g->scale;
     
     // Title
-    SDL_Surface *title_surface = TTF_RenderText_Solid(g->info_font, "How to Play MindSweeper", yellow);
-    if (title_surface) {
-        SDL_Texture *title_texture = SDL_CreateTextureFromSurface(g->renderer, title_surface);
-        if (title_texture) {
-            SDL_Rect title_rect = {start_x, 20 * g->scale, title_surface->w, title_surface->h};
-            SDL_RenderCopy(g->renderer, title_texture, NULL, &title_rect);
-            SDL_DestroyTexture(title_texture);
-        }
-        SDL_FreeSurface(title_surface);
-    }
+    text_cache_draw(g->text_cache, g->info_font, "How to Play MindSweeper", yellow,
+                    start_x, 20 * g->scale);
     
     // How-to-play content (simplified for space)
     const char* lines[] = {
@@ -1473,16 +1416,8 @@ void game_draw_howto_screen(const struct Game *g) {
             color = cyan; // Headers in cyan
         }
         
-        SDL_Surface *line_surface = TTF_RenderText_Solid(g->info_font, lines[i], color);
-        if (line_surface) {
-            SDL_Texture *line_texture = SDL_CreateTextureFromSurface(g->renderer, line_surface);
-            if (line_texture) {
-                SDL_Rect line_rect = {start_x, current_y, line_surface->w, line_surface->h};
-                SDL_RenderCopy(g->renderer, line_texture, NULL, &line_rect);
-                SDL_DestroyTexture(line_texture);
-            }
-            SDL_FreeSurface(line_surface);
-        }
+        text_cache_draw(g->text_cache, g->info_font, lines[i], color,
+                        start_x, current_y);
         current_y += line_height;
     }
 }
@@ -6,15 +6,9 @@
 #include "board.h"
 #include "clock.h"
 #include "face.h"
-
-// Player stats structure
-typedef struct {
-    unsigned level;
-    unsigned health;
-    unsigned max_health;
-    unsigned experience;
-    unsigned exp_to_next_level;
-} PlayerStats;
+#include "game_state.h"
+#include "solution_catalog.h"
+#include "text_cache.h"
 
 // UI Screen states for different information screens
 typedef enum {
@@ -30,12 +24,6 @@ typedef struct {
     SDL_Rect back_button;          // "Back" button (shown on info screens)
 } ScreenButtons;
 
-// Game over information
-typedef struct {
-    bool is_game_over;
-    char death_cause[MAX_ENTITY_NAME];  // Name of entity that killed player
-} GameOverInfo;
-
 // Player panel for displaying stats
 typedef struct {
     SDL_Renderer *renderer;
@@ -47,6 +35,7 @@ typedef struct {
     SDL_Texture *sprite_sheet; // For level-up button sprite
     SDL_Rect *sprite_src_rects; // Source rectangles for sprites
     TTF_Font *font;             // TTF font for text rendering
+    TextCache *text_cache;      // Rendered stat and game-over text
 } PlayerPanel;
 
 // Admin panel state
@@ -65,14 +54,20 @@ struct Game {
         struct Board *board;
         struct Clock *clock;
         struct Face *face;
+        SolutionCatalog solutions;     // Opened once in game_new
+        GameConfig config;             // Loaded once in game_new
+        GameState state;               // Board contents, player stats and game over
+        uint64_t session_seed;         // MINDSWEEPER_SEED, else from the clock
+        Rng rng;                       // Session stream: solution choice and each game's seed
         PlayerPanel *player_panel;
-        PlayerStats player;
         AdminPanel admin;
         UIScreenState current_screen;  // Current UI screen state
         ScreenButtons screen_buttons;  // Screen toggle buttons
         TTF_Font *info_font;          // Font for information screens
+        TextCache *text_cache;        // Rendered hint, button and info screen text
         bool is_running;
-        GameOverInfo game_over_info;  // Replaced simple boolean with detailed info
+        bool needs_redraw;            // Something visible changed since the last game_draw
+        bool vsync;                   // Renderer presents in step with the display
         unsigned rows;
         unsigned columns;
         int scale;
@@ -85,10 +80,6 @@ bool game_run(struct Game *g);
 
 // Player stats functions
 void game_init_player_stats(struct Game *g);
-void game_update_player_health(struct Game *g, int health_change);
-void game_level_up_player(struct Game *g);
-unsigned game_calculate_max_health(unsigned level);
-unsigned game_calculate_exp_requirement(unsigned level);
 
 // Screen management functions
 void game_init_screen_system(struct Game *g);
@@ -121,6 +112,8 @@ void player_panel_draw_text(const PlayerPanel *p, const char *text, int x, int y
 // Game over functions
 void game_check_game_over(struct Game *g);
 void game_set_game_over(struct Game *g, const char *entity_name);
+// Shows the game over the game state already entered
+void game_show_game_over(struct Game *g);
 void game_draw_game_over_popup(const struct Game *g);
 void game_reset_game_over(struct Game *g);
 
@@ -0,0 +1,575 @@
+#include "game_state.h"
+#include "entity_logic.h"
+#include "log.h"
+#include <string.h>
+
+static void game_state_free_arrays(GameState *s);
+static void game_state_spread_threat(GameState *s, unsigned row, unsigned col, unsigned threat, int sign);
+static void game_state_calculate_threat_levels(GameState *s);
+
+static void game_state_notify_tile(const GameState *s, size_t index) {
+    if (s->observer.tile_changed) {
+        s->observer.tile_changed(s->observer.context, index);
+    }
+}
+
+bool game_state_init(GameState *s, const GameConfig *config, unsigned rows, unsigned columns) {
+    if (!s || !config) {
+        fprintf(stderr, "Invalid parameters to game_state_init\n");
+        return false;
+    }
+
+    memset(s, 0, sizeof(*s));
+    s->config = config;
+    game_state_seed(s, 0);
+    if (!game_state_resize(s, rows, columns)) {
+        return false;
+    }
+
+    game_state_init_player(s);
+    return true;
+}
+
+void game_state_free(GameState *s) {
+    if (!s) {
+        return;
+    }
+    game_state_free_arrays(s);
+    s->observer = (GameStateObserver){0};
+}
+
+void game_state_seed(GameState *s, uint64_t seed) {
+    s->seed = seed;
+    rng_seed(&s->rng, seed, 0);
+}
+
+static void game_state_free_arrays(GameState *s) {
+    free(s->entity_ids);
+    s->entity_ids = NULL;
+    free(s->tile_states);
+    s->tile_states = NULL;
+    free(s->threat_levels);
+    s->threat_levels = NULL;
+    free(s->transitions);
+    s->transitions = NULL;
+    free(s->transition_due);
+    s->transition_due = NULL;
+    free(s->pending);
+    s->pending = NULL;
+    s->pending_count = 0;
+}
+
+bool game_state_resize(GameState *s, unsigned rows, unsigned columns) {
+    if (rows == 0 || columns == 0) {
+        fprintf(stderr, "Invalid parameters to game_state_resize\n");
+        return false;
+    }
+
+    game_state_free_arrays(s);
+    s->rows = rows;
+    s->columns = columns;
+
+    // calloc leaves every tile empty (entity 0), hidden and without a transition
+    size_t total_tiles = (size_t)rows * columns;
+    s->entity_ids = calloc(total_tiles, sizeof(unsigned));
+    s->tile_states = calloc(total_tiles, sizeof(TileState));
+    s->threat_levels = calloc(total_tiles, sizeof(unsigned));
+    s->transitions = calloc(total_tiles, sizeof(GameTransition));
+    s->transition_due = calloc(total_tiles, sizeof(uint32_t));
+    s->pending = calloc(total_tiles, sizeof(unsigned));
+    if (!s->entity_ids || !s->tile_states || !s->threat_levels ||
+        !s->transitions || !s->transition_due || !s->pending) {
+        fprintf(stderr, "Error in calloc of game state arrays.\n");
+        game_state_free_arrays(s);
+        return false;
+    }
+
+    return true;
+}
+
+// Hides every tile and drops pending transitions after new entity IDs were written
+static void game_state_reset_tiles(GameState *s) {
+    size_t total_tiles = (size_t)s->rows * s->columns;
+    for (size_t index = 0; index < total_tiles; index++) {
+        s->tile_states[index] = TILE_HIDDEN;
+        s->transitions[index] = GAME_TRANSITION_NONE;
+    }
+    s->pending_count = 0;
+
+    game_state_calculate_threat_levels(s);
+}
+
+bool game_state_load(GameState *s, SolutionCatalog *solutions, unsigned solution_index) {
+    // Write entity IDs directly instead of going through game_state_set_entity_id,
+    // which would recompute every threat level once per cell.
+    if (!solution_catalog_board(solutions, solution_index, s->rows, s->columns, s->entity_ids)) {
+        fprintf(stderr, "Failed to load solution\n");
+        return false;
+    }
+
+    LOG_INFO(LOG_CAT_BOARD, "Loaded solution %u: %s (%ux%u)", solution_index,
+                            solution_catalog_uuid(solutions, solution_index), s->rows, s->columns);
+
+    game_state_reset_tiles(s);
+    return true;
+}
+
+void game_state_set_board(GameState *s, const unsigned *entity_ids) {
+    memcpy(s->entity_ids, entity_ids, (size_t)s->rows * s->columns * sizeof(unsigned));
+    game_state_reset_tiles(s);
+}
+
+void game_state_clear(GameState *s) {
+    memset(s->entity_ids, 0, (size_t)s->rows * s->columns * sizeof(unsigned));
+    game_state_reset_tiles(s);
+}
+
+unsigned game_state_entity_id(const GameState *s, unsigned row, unsigned col) {
+    if (row >= s->rows || col >= s->columns) {
+        return 0; // Return empty entity for out of bounds
+    }
+    return s->entity_ids[(size_t)row * s->columns + col];
+}
+
+void game_state_set_entity_id(GameState *s, unsigned row, unsigned col, unsigned entity_id) {
+    if (row >= s->rows || col >= s->columns) {
+        return; // Ignore out of bounds
+    }
+    size_t index = (size_t)row * s->columns + col;
+    unsigned old_threat = config_entity_threat(s->config, s->entity_ids[index]);
+    unsigned new_threat = config_entity_threat(s->config, entity_id);
+    s->entity_ids[index] = entity_id;
+    game_state_notify_tile(s, index);
+
+    // Only the 8 neighbours see the change in threat
+    if (new_threat != old_threat) {
+        game_state_spread_threat(s, row, col, old_threat, -1);
+        game_state_spread_threat(s, row, col, new_threat, 1);
+    }
+}
+
+TileState game_state_tile_state(const GameState *s, unsigned row, unsigned col) {
+    if (row >= s->rows || col >= s->columns) {
+        return TILE_HIDDEN; // Return hidden for out of bounds
+    }
+    return s->tile_states[(size_t)row * s->columns + col];
+}
+
+void game_state_reveal(GameState *s, unsigned row, unsigned col) {
+    if (row >= s->rows || col >= s->columns) {
+        return; // Ignore out of bounds
+    }
+    size_t index = (size_t)row * s->columns + col;
+    s->tile_states[index] = TILE_REVEALED;
+    game_state_notify_tile(s, index);
+}
+
+// Adds the threat weight of the entity at (row, col) to its 8 neighbours, or
+// removes it when sign is -1.
+static void game_state_spread_threat(GameState *s, unsigned row, unsigned col, unsigned threat, int sign) {
+    unsigned row_start = row > 0 ? row - 1 : 0;
+    unsigned row_end = row + 1 < s->rows ? row + 1 : row;
+    unsigned col_start = col > 0 ? col - 1 : 0;
+    unsigned col_end = col + 1 < s->columns ? col + 1 : col;
+
+    for (unsigned r = row_start; r <= row_end; r++) {
+        unsigned *levels = s->threat_levels + (size_t)r * s->columns;
+        for (unsigned c = col_start; c <= col_end; c++) {
+            if (r == row && c == col) continue;
+            if (sign > 0) {
+                levels[c] += threat;
+            } else {
+                levels[c] -= threat;
+            }
+            game_state_notify_tile(s, (size_t)r * s->columns + c);
+        }
+    }
+}
+
+// Full pass, only needed when a whole board is loaded. threat_levels holds the
+// neighbour sum for every cell; it is only shown on empty tiles. Like the rest
+// of a bulk load this does not notify the observer.
+static void game_state_calculate_threat_levels(GameState *s) {
+    size_t total_tiles = (size_t)s->rows * s->columns;
+    memset(s->threat_levels, 0, total_tiles * sizeof(unsigned));
+
+    for (unsigned row = 0; row < s->rows; row++) {
+        for (unsigned col = 0; col < s->columns; col++) {
+            unsigned threat = config_entity_threat(s->config, s->entity_ids[(size_t)row * s->columns + col]);
+            if (threat == 0) {
+                continue;
+            }
+            unsigned row_end = row + 1 < s->rows ? row + 1 : row;
+            unsigned col_start = col > 0 ? col - 1 : 0;
+            unsigned col_end = col + 1 < s->columns ? col + 1 : col;
+            for (unsigned r = row > 0 ? row - 1 : 0; r <= row_end; r++) {
+                unsigned *levels = s->threat_levels + (size_t)r * s->columns;
+                for (unsigned c = col_start; c <= col_end; c++) {
+                    if (r != row || c != col) {
+                        levels[c] += threat;
+                    }
+                }
+            }
+        }
+    }
+}
+
+unsigned game_state_threat_level(const GameState *s, unsigned row, unsigned col) {
+    if (row >= s->rows || col >= s->columns) {
+        return 0;
+    }
+    size_t index = (size_t)row * s->columns + col;
+    return s->entity_ids[index] == 0 ? s->threat_levels[index] : 0;
+}
+
+// ========== PLAY ==========
+
+// Queues the entity change for the tile, replacing one that is already pending
+static void game_state_schedule(GameState *s, size_t index, GameTransition transition, uint32_t due) {
+    if (s->transitions[index] == GAME_TRANSITION_NONE) {
+        s->pending[s->pending_count++] = (unsigned)index;
+    }
+    s->transitions[index] = transition;
+    s->transition_due[index] = due;
+}
+
+// Reveals the hidden tile at (row, col); false when there is none to reveal
+static bool game_state_reveal_hidden(GameState *s, unsigned row, unsigned col) {
+    if (row >= s->rows || col >= s->columns ||
+        s->tile_states[(size_t)row * s->columns + col] != TILE_HIDDEN) {
+        return false;
+    }
+    game_state_reveal(s, row, col);
+    return true;
+}
+
+// Index of a hidden tile picked uniformly at random, SIZE_MAX if none is left
+static size_t game_state_random_hidden(GameState *s) {
+    size_t total_tiles = (size_t)s->rows * s->columns;
+    size_t hidden = 0;
+    for (size_t i = 0; i < total_tiles; i++) {
+        hidden += s->tile_states[i] == TILE_HIDDEN;
+    }
+    if (hidden == 0) {
+        return SIZE_MAX;
+    }
+
+    size_t pick = rng_below(&s->rng, (uint32_t)hidden);
+    for (size_t i = 0; i < total_tiles; i++) {
+        if (s->tile_states[i] == TILE_HIDDEN && pick-- == 0) {
+            return i;
+        }
+    }
+    return SIZE_MAX;
+}
+
+// Reveals every hidden tile whose entity matches; by_group picks EN group
+// members, otherwise entity ID `match`
+static unsigned game_state_reveal_matching(GameState *s, bool by_group, unsigned match) {
+    unsigned revealed = 0;
+    size_t total_tiles = (size_t)s->rows * s->columns;
+    for (size_t i = 0; i < total_tiles; i++) {
+        if (s->tile_states[i] != TILE_HIDDEN) continue;
+        unsigned entity_id = s->entity_ids[i];
+        const EntityLookup *lookup = config_lookup(s->config, entity_id);
+        bool matches = by_group ? lookup && ((lookup->groups >> match) & 1u) : entity_id == match;
+        if (matches) {
+            game_state_reveal(s, (unsigned)(i / s->columns), (unsigned)(i % s->columns));
+            revealed++;
+        }
+    }
+    return revealed;
+}
+
+// Runs the entity's effects for `when` (EFFECT_ON_*); true if one won the game
+static bool game_state_run_effects(GameState *s, const EntityLookup *lookup, unsigned when) {
+    bool won = false;
+    for (unsigned i = 0; i < lookup->effect_count; i++) {
+        const Effect *effect = &lookup->effects[i];
+        if (!(effect->flags & when)) continue;
+
+        switch ((EffectOpcode)effect->opcode) {
+            case EFFECT_HEAL:
+                game_state_change_health(s, effect->argument);
+                LOG_INFO(LOG_CAT_CLICK, "Player healed for %u HP. New HP: %u", effect->argument, s->player.health);
+                break;
+            case EFFECT_GAIN_EXPERIENCE:
+                s->player.experience += effect->argument;
+                LOG_INFO(LOG_CAT_CLICK, "Experience added - %u. New XP: %u", effect->argument, s->player.experience);
+                break;
+            case EFFECT_REVEAL_RANDOM:
+                for (unsigned n = 0; n < effect->argument; n++) {
+                    size_t index = game_state_random_hidden(s);
+                    if (index == SIZE_MAX) break;
+                    game_state_reveal(s, (unsigned)(index / s->columns), (unsigned)(index % s->columns));
+                }
+                break;
+            case EFFECT_REVEAL_SQUARE: {
+                size_t index = game_state_random_hidden(s);
+                if (index == SIZE_MAX) break;
+                unsigned radius = effect->argument / 2u;
+                unsigned centre_row = (unsigned)(index / s->columns);
+                unsigned centre_col = (unsigned)(index % s->columns);
+                unsigned revealed = 0;
+                for (unsigned r = centre_row > radius ? centre_row - radius : 0; r <= centre_row + radius; r++) {
+                    for (unsigned c = centre_col > radius ? centre_col - radius : 0; c <= centre_col + radius; c++) {
+                        revealed += game_state_reveal_hidden(s, r, c);
+                    }
+                }
+                LOG_INFO(LOG_CAT_CLICK, "Revealed %u tiles around [%u,%u]", revealed, centre_row, centre_col);
+                break;
+            }
+            case EFFECT_REVEAL_GROUP:
+                LOG_INFO(LOG_CAT_CLICK, "Revealed %u E%u entities",
+                         game_state_reveal_matching(s, true, effect->argument), effect->argument);
+                break;
+            case EFFECT_REVEAL_ENTITY:
+                LOG_INFO(LOG_CAT_CLICK, "Revealed %u of entity %u",
+                         game_state_reveal_matching(s, false, effect->argument), effect->argument);
+                break;
+            case EFFECT_WIN_GAME:
+                won = true;
+                break;
+        }
+    }
+    return won;
+}
+
+GameClickResult game_state_click(GameState *s, unsigned row, unsigned col, uint32_t now_ms) {
+    if (row >= s->rows || col >= s->columns || s->game_over.is_game_over) {
+        return GAME_CLICK_IGNORED;
+    }
+
+    size_t index = (size_t)row * s->columns + col;
+    TileState current_state = s->tile_states[index];
+    unsigned entity_id = s->entity_ids[index];
+    const EntityLookup *lookup = config_lookup(s->config, entity_id);
+    const Entity *entity = lookup ? lookup->entity : NULL;
+
+    if (entity) {
+        LOG_DEBUG(LOG_CAT_CLICK, "Clicked [%u,%u]: %s (ID: %u, Level: %u, Count: %u)",
+                  row, col, entity->name, entity->id, entity->level, entity->count);
+        LOG_DEBUG(LOG_CAT_CLICK, "  Description: %s", entity->description);
+        LOG_DEBUG(LOG_CAT_CLICK, "  Is Enemy: %s, Is Item: %s, Blocks Input on Reveal: %s",
+                  entity->is_enemy ? "true" : "false", entity->is_item ? "true" : "false",
+                  entity->blocks_input_on_reveal ? "true" : "false");
+        LOG_DEBUG(LOG_CAT_CLICK, "  Sprite Position: x=%u, y=%u, Effects: %u",
+                  entity->sprite_pos.x, entity->sprite_pos.y, lookup->effect_count);
+    }
+
+    // Handle enemy combat regardless of tile state (hidden or revealed)
+    if (entity && entity->level > 0) {
+        game_state_change_health(s, -(int)entity->level);
+        if (!entity->no_experience) {
+            s->player.experience += entity->level;
+        }
+
+        LOG_INFO(LOG_CAT_CLICK, "Combat with enemy %s (ID: %u) - Player HP: %u, XP: %u",
+                                entity->name, entity->id, s->player.health, s->player.experience);
+
+        // A fatal fight leaves the tile as it was
+        if (s->player.health == 0) {
+            game_state_set_game_over(s, entity->name);
+            return GAME_CLICK_DIED;
+        }
+
+        if (current_state == TILE_HIDDEN) {
+            game_state_reveal(s, row, col);
+        }
+
+        // Fighting again before the enemy clears restarts its countdown
+        game_state_schedule(s, index, GAME_TRANSITION_CLEARED, now_ms + GAME_COMBAT_TRANSITION_MS);
+        if (game_state_run_effects(s, lookup, EFFECT_ON_DEFEAT)) {
+            game_state_set_won(s);
+            return GAME_CLICK_WON;
+        }
+        return GAME_CLICK_COMBAT;
+    }
+
+    if (current_state == TILE_HIDDEN) {
+        LOG_DEBUG(LOG_CAT_CLICK, "Revealing tile [%u,%u] with entity %u", row, col, entity_id);
+        game_state_reveal(s, row, col);
+        return GAME_CLICK_REVEALED;
+    }
+
+    // Items and triggers are used up once; a claim waiting on its transition
+    // does not run the effects again
+    if (!entity || !(entity->is_item || entity->is_trigger) ||
+        s->transitions[index] == GAME_TRANSITION_CLAIMED) {
+        return GAME_CLICK_NOTHING;
+    }
+
+    game_state_schedule(s, index, GAME_TRANSITION_CLAIMED, now_ms + GAME_CLAIM_TRANSITION_MS);
+    if (game_state_run_effects(s, lookup, EFFECT_ON_CLAIM)) {
+        game_state_set_won(s);
+        return GAME_CLICK_WON;
+    }
+    return GAME_CLICK_CLAIMED;
+}
+
+static void game_state_apply_transition(GameState *s, size_t index, GameTransition transition) {
+    unsigned row = (unsigned)(index / s->columns);
+    unsigned col = (unsigned)(index % s->columns);
+    unsigned current_entity_id = s->entity_ids[index];
+    const EntityLookup *lookup = config_lookup(s->config, current_entity_id);
+    unsigned new_entity_id;
+
+    if (transition == GAME_TRANSITION_CLEARED) {
+        if (!lookup || !lookup->entity) {
+            return;
+        }
+        new_entity_id = choose_entity_transition(lookup, &s->rng);
+        if (new_entity_id == current_entity_id) {
+            return; // Enemy stays
+        }
+        LOG_DEBUG(LOG_CAT_ANIM, "Enemy cleared at [%u,%u]: %u -> %u", row, col, current_entity_id, new_entity_id);
+    } else {
+        // A claimed item never stays: without a transition it leaves Empty
+        new_entity_id = lookup && lookup->entity ? choose_entity_transition(lookup, &s->rng) : 0;
+        if (new_entity_id == current_entity_id) {
+            new_entity_id = 0;
+        }
+        LOG_DEBUG(LOG_CAT_ANIM, "Treasure transition at [%u,%u]: %u -> %u", row, col, current_entity_id, new_entity_id);
+    }
+
+    game_state_set_entity_id(s, row, col, new_entity_id);
+    if (s->observer.entity_transitioned) {
+        s->observer.entity_transitioned(s->observer.context, index);
+    }
+}
+
+unsigned game_state_advance(GameState *s, uint32_t now_ms) {
+    unsigned applied = 0;
+    unsigned slot = 0;
+    while (slot < s->pending_count) {
+        unsigned index = s->pending[slot];
+        if ((int32_t)(now_ms - s->transition_due[index]) < 0) {
+            slot++;
+            continue;
+        }
+
+        GameTransition transition = s->transitions[index];
+        s->transitions[index] = GAME_TRANSITION_NONE;
+        s->pending[slot] = s->pending[--s->pending_count];
+        game_state_apply_transition(s, index, transition);
+        applied++;
+    }
+    return applied;
+}
+
+bool game_state_has_pending(const GameState *s) {
+    return s->pending_count > 0;
+}
+
+uint32_t game_state_next_due(const GameState *s) {
+    uint32_t due = s->transition_due[s->pending[0]];
+    for (unsigned slot = 1; slot < s->pending_count; slot++) {
+        uint32_t next = s->transition_due[s->pending[slot]];
+        if ((int32_t)(next - due) < 0) {
+            due = next;
+        }
+    }
+    return due;
+}
+
+// ========== PLAYER STATS ==========
+
+void game_state_init_player(GameState *s) {
+    // Get starting level from config
+    unsigned starting_level = s->config->starting_level > 0 ? s->config->starting_level : 1;
+    game_state_set_player_level(s, starting_level);
+
+    LOG_INFO(LOG_CAT_GAME, "Player initialized: Level %u, Health %u/%u, Exp %u/%u",
+                           s->player.level, s->player.health, s->player.max_health,
+                           s->player.experience, s->player.exp_to_next_level);
+}
+
+// Puts the player at the start of the level with full health
+void game_state_set_player_level(GameState *s, unsigned level) {
+    s->player.level = level;
+    s->player.max_health = game_calculate_max_health(level);
+    s->player.health = s->player.max_health;
+    s->player.experience = 0;
+    s->player.exp_to_next_level = game_calculate_exp_requirement(level);
+}
+
+void game_state_change_health(GameState *s, int health_change) {
+    if (health_change < 0) {
+        unsigned damage = (unsigned)(-health_change);
+        if (damage >= s->player.health) {
+            s->player.health = 0;
+        } else {
+            s->player.health -= damage;
+        }
+    } else {
+        s->player.health += (unsigned)health_change;
+        if (s->player.health > s->player.max_health) {
+            s->player.health = s->player.max_health;
+        }
+    }
+
+    LOG_DEBUG(LOG_CAT_GAME, "Player health: %u/%u", s->player.health, s->player.max_health);
+}
+
+bool game_state_can_level_up(const GameState *s) {
+    return s->player.experience >= s->player.exp_to_next_level;
+}
+
+void game_state_level_up(GameState *s) {
+    // Handle multiple level-ups if player has gained enough experience
+    while (s->player.experience >= s->player.exp_to_next_level) {
+        // Calculate excess experience that carries over to next level
+        unsigned excess_exp = s->player.experience - s->player.exp_to_next_level;
+
+        s->player.level++;
+        s->player.experience = excess_exp;  // Carry over excess experience
+        s->player.max_health = game_calculate_max_health(s->player.level);
+        s->player.health = s->player.max_health; // Full heal on level up
+        s->player.exp_to_next_level = game_calculate_exp_requirement(s->player.level);
+
+        LOG_INFO(LOG_CAT_GAME, "LEVEL UP! Player is now level %u with %u health (excess exp: %u)",
+                               s->player.level, s->player.max_health, excess_exp);
+    }
+}
+
+unsigned game_calculate_max_health(unsigned level) {
+    if (level >= GOD_MODE_LEVEL) {
+        return GOD_MODE_HEALTH; // GOD mode health
+    }
+    return BASE_HEALTH + (level * HEALTH_PER_LEVEL); // Base health + 2 per level
+}
+
+unsigned game_calculate_exp_requirement(unsigned level) {
+    return level * EXP_PER_LEVEL_MULTIPLIER; // Simple exp curve: 5, 10, 15, 20, etc.
+}
+
+// ========== GAME OVER ==========
+
+void game_state_set_game_over(GameState *s, const char *entity_name) {
+    s->game_over.is_game_over = true;
+
+    // Copy the entity name safely
+    if (entity_name) {
+        strncpy(s->game_over.death_cause, entity_name, MAX_ENTITY_NAME - 1);
+        s->game_over.death_cause[MAX_ENTITY_NAME - 1] = '\0'; // Ensure null termination
+    } else {
+        strcpy(s->game_over.death_cause, "Unknown");
+    }
+
+    LOG_INFO(LOG_CAT_GAME, "=== GAME OVER ===");
+    LOG_INFO(LOG_CAT_GAME, "Death by %s!", s->game_over.death_cause);
+}
+
+void game_state_set_won(GameState *s) {
+    s->game_over.is_game_over = true;
+    s->game_over.is_won = true;
+    s->game_over.death_cause[0] = '\0';
+
+    LOG_INFO(LOG_CAT_GAME, "=== VICTORY ===");
+}
+
+void game_state_reset_game_over(GameState *s) {
+    s->game_over.is_game_over = false;
+    s->game_over.is_won = false;
+    s->game_over.death_cause[0] = '\0'; // Clear death cause
+}
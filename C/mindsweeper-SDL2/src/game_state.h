@@ -0,0 +1,140 @@
+#ifndef GAME_STATE_H
+#define GAME_STATE_H
+
+#include "config.h"
+#include "rng.h"
+#include "solution_catalog.h"
+#include <stdint.h>
+
+// Game rules without rendering: board contents, threat levels, player stats
+// and the entity transitions that follow combat and item claims. Nothing here
+// reads the SDL clock or touches a renderer; callers pass the time in, so the
+// same code runs behind the SDL board and in headless simulations.
+//
+// Every random draw (treasure and enemy drops) comes from the state's own
+// generator, so a game replays exactly from its seed and separate states can
+// run on separate threads.
+//
+// Views follow changes through GameStateObserver. Bulk changes (loading or
+// clearing the board) are not reported tile by tile; the view resyncs after
+// them.
+
+// Time from the click until a defeated enemy or claimed item changes entity,
+// matching the animations the SDL board plays in between
+#define GAME_COMBAT_TRANSITION_MS (ANIM_COMBAT_DURATION_MS + ANIM_COMBAT_STAGE2_DURATION_MS)
+#define GAME_CLAIM_TRANSITION_MS ANIM_TREASURE_DURATION_MS
+
+// Tile states
+typedef enum {
+    TILE_HIDDEN = 0,
+    TILE_REVEALED = 1
+} TileState;
+
+// Player stats structure
+typedef struct {
+    unsigned level;
+    unsigned health;
+    unsigned max_health;
+    unsigned experience;
+    unsigned exp_to_next_level;
+} PlayerStats;
+
+// Game over information
+typedef struct {
+    bool is_game_over;
+    bool is_won;                        // Ended by a trigger-win-game claim, not a death
+    char death_cause[MAX_ENTITY_NAME];  // Name of entity that killed player
+} GameOverInfo;
+
+// What a click on a tile did
+typedef enum {
+    GAME_CLICK_IGNORED = 0,  // Out of bounds or the game is over
+    GAME_CLICK_NOTHING,      // Revealed tile with nothing to fight or claim
+    GAME_CLICK_REVEALED,     // Hidden tile revealed
+    GAME_CLICK_COMBAT,       // Fought the enemy, which transitions later
+    GAME_CLICK_CLAIMED,      // Claimed the item, which transitions later
+    GAME_CLICK_DIED,         // The enemy killed the player
+    GAME_CLICK_WON           // Claimed an item that wins the game
+} GameClickResult;
+
+// Entity change waiting for its due time
+typedef enum {
+    GAME_TRANSITION_NONE = 0,
+    GAME_TRANSITION_CLEARED, // Defeated enemy becomes its on_cleared entity
+    GAME_TRANSITION_CLAIMED  // Claimed item becomes its on_cleared entity, else Empty
+} GameTransition;
+
+typedef struct {
+    void *context;
+    // Entity, state or threat level of the tile changed
+    void (*tile_changed)(void *context, size_t index);
+    // A pending transition replaced the entity on the tile
+    void (*entity_transitioned)(void *context, size_t index);
+} GameStateObserver;
+
+typedef struct {
+    const GameConfig *config;
+    unsigned rows;
+    unsigned columns;
+
+    unsigned *entity_ids;            // 1D array: entity ID occupying each cell
+    TileState *tile_states;          // 1D array: hidden/revealed mask
+    unsigned *threat_levels;         // 1D array: sum of neighbour threat, shown on empty tiles
+
+    GameTransition *transitions;     // 1D array: pending entity change per tile
+    uint32_t *transition_due;        // 1D array: time the pending change applies
+    unsigned *pending;               // Tiles with a pending transition
+    unsigned pending_count;
+
+    PlayerStats player;
+    GameOverInfo game_over;
+
+    uint64_t seed;                   // Seed of the current game
+    Rng rng;                         // Drawn from for random transitions
+
+    GameStateObserver observer;
+} GameState;
+
+bool game_state_init(GameState *s, const GameConfig *config, unsigned rows, unsigned columns);
+void game_state_free(GameState *s);
+// Reallocates the board for a new size; every tile is empty and hidden
+bool game_state_resize(GameState *s, unsigned rows, unsigned columns);
+
+// Restarts the random transitions from seed; game_state_init seeds with 0
+void game_state_seed(GameState *s, uint64_t seed);
+
+// Board contents
+bool game_state_load(GameState *s, SolutionCatalog *solutions, unsigned solution_index);
+// Copies in rows x columns entity IDs, e.g. a board read once and replayed
+void game_state_set_board(GameState *s, const unsigned *entity_ids);
+void game_state_clear(GameState *s);
+unsigned game_state_entity_id(const GameState *s, unsigned row, unsigned col);
+void game_state_set_entity_id(GameState *s, unsigned row, unsigned col, unsigned entity_id);
+TileState game_state_tile_state(const GameState *s, unsigned row, unsigned col);
+void game_state_reveal(GameState *s, unsigned row, unsigned col);
+// Threat level shown on the tile: the neighbour sum on empty tiles, else 0
+unsigned game_state_threat_level(const GameState *s, unsigned row, unsigned col);
+
+// Play
+GameClickResult game_state_click(GameState *s, unsigned row, unsigned col, uint32_t now_ms);
+// Applies every pending transition due at now_ms and returns how many ran
+unsigned game_state_advance(GameState *s, uint32_t now_ms);
+bool game_state_has_pending(const GameState *s);
+// Time the earliest pending transition is due; needs game_state_has_pending
+uint32_t game_state_next_due(const GameState *s);
+
+// Player stats
+void game_state_init_player(GameState *s);
+void game_state_set_player_level(GameState *s, unsigned level);
+void game_state_change_health(GameState *s, int health_change);
+bool game_state_can_level_up(const GameState *s);
+void game_state_level_up(GameState *s);
+unsigned game_calculate_max_health(unsigned level);
+unsigned game_calculate_exp_requirement(unsigned level);
+
+// Game over
+void game_state_set_game_over(GameState *s, const char *entity_name);
+void game_state_set_won(GameState *s);
+void game_state_reset_game_over(GameState *s);
+
+#endif
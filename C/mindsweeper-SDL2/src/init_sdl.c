@@ -25,12 +25,25 @@ bool game_init_sdl(struct Game *g) {
         return false;
     }
 
-    g->renderer = SDL_CreateRenderer(g->window, -1, SDL_RENDERER_ACCELERATED);
+    // The board is cached in a render-target texture
+    Uint32 renderer_flags = SDL_RENDERER_ACCELERATED | SDL_RENDERER_TARGETTEXTURE;
+#if GAME_VSYNC
+    renderer_flags |= SDL_RENDERER_PRESENTVSYNC;
+#endif
+    g->renderer = SDL_CreateRenderer(g->window, -1, renderer_flags);
     if (!g->renderer) {
         fprintf(stderr, "Error creating renderer: %s\n", SDL_GetError());
         return false;
     }
 
+    // Drivers may ignore the vsync request; the game loop then paces itself
+    SDL_RendererInfo info;
+    if (SDL_GetRendererInfo(g->renderer, &info) != 0) {
+        fprintf(stderr, "Error querying renderer: %s\n", SDL_GetError());
+        return false;
+    }
+    g->vsync = (info.flags & SDL_RENDERER_PRESENTVSYNC) != 0;
+
     SDL_Surface *icon_surf = IMG_Load("images/icon.png");
     if (icon_surf) {
         SDL_SetWindowIcon(g->window, icon_surf);
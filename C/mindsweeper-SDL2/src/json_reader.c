@@ -0,0 +1,431 @@
+#include "json_reader.h"
+#include <stdio.h>
+#include <string.h>
+
+static bool json_reader_fail(JsonReader *r, const char *error) {
+    if (!r->error) {
+        r->error = error;
+        r->error_pos = r->pos;
+    }
+    return false;
+}
+
+static void json_reader_skip_whitespace(JsonReader *r) {
+    while (r->pos < r->size) {
+        char c = r->data[r->pos];
+        if (c != ' ' && c != '\t' && c != '\n' && c != '\r') {
+            break;
+        }
+        r->pos++;
+    }
+}
+
+static bool json_reader_in_object(const JsonReader *r) {
+    return r->depth > 0 && (r->object_mask >> (r->depth - 1)) & 1u;
+}
+
+static bool json_reader_scan_string(JsonReader *r, JsonToken *token) {
+    r->pos++; // Opening quote
+    token->start = r->data + r->pos;
+    token->escaped = false;
+
+    while (r->pos < r->size) {
+        unsigned char c = (unsigned char)r->data[r->pos];
+        if (c == '"') {
+            token->length = (size_t)(r->data + r->pos - token->start);
+            r->pos++;
+            return true;
+        }
+        if (c < 0x20) {
+            return json_reader_fail(r, "control character in string");
+        }
+        if (c == '\\') {
+            token->escaped = true;
+            r->pos++;
+        }
+        r->pos++;
+    }
+
+    return json_reader_fail(r, "unterminated string");
+}
+
+static bool json_is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+static bool json_reader_scan_number(JsonReader *r, JsonToken *token) {
+    size_t start = r->pos;
+    const char *d = r->data;
+
+    if (r->pos < r->size && d[r->pos] == '-') {
+        r->pos++;
+    }
+    if (r->pos >= r->size || !json_is_digit(d[r->pos])) {
+        return json_reader_fail(r, "invalid number");
+    }
+    if (d[r->pos] == '0') {
+        r->pos++;
+    } else {
+        while (r->pos < r->size && json_is_digit(d[r->pos])) r->pos++;
+    }
+    if (r->pos < r->size && d[r->pos] == '.') {
+        r->pos++;
+        if (r->pos >= r->size || !json_is_digit(d[r->pos])) {
+            return json_reader_fail(r, "invalid number");
+        }
+        while (r->pos < r->size && json_is_digit(d[r->pos])) r->pos++;
+    }
+    if (r->pos < r->size && (d[r->pos] == 'e' || d[r->pos] == 'E')) {
+        r->pos++;
+        if (r->pos < r->size && (d[r->pos] == '+' || d[r->pos] == '-')) r->pos++;
+        if (r->pos >= r->size || !json_is_digit(d[r->pos])) {
+            return json_reader_fail(r, "invalid number");
+        }
+        while (r->pos < r->size && json_is_digit(d[r->pos])) r->pos++;
+    }
+
+    token->type = JSON_TOKEN_NUMBER;
+    token->start = d + start;
+    token->length = r->pos - start;
+    return true;
+}
+
+static bool json_reader_scan_literal(JsonReader *r, JsonToken *token,
+                                     const char *literal, JsonTokenType type) {
+    size_t length = strlen(literal);
+    if (r->size - r->pos < length || memcmp(r->data + r->pos, literal, length) != 0) {
+        return json_reader_fail(r, "unexpected character");
+    }
+
+    token->type = type;
+    token->start = r->data + r->pos;
+    token->length = length;
+    r->pos += length;
+    return true;
+}
+
+static bool json_reader_open(JsonReader *r, JsonToken *token, bool is_object) {
+    if (r->depth >= JSON_READER_MAX_DEPTH) {
+        return json_reader_fail(r, "nesting too deep");
+    }
+
+    if (is_object) {
+        r->object_mask |= (uint64_t)1 << r->depth;
+    } else {
+        r->object_mask &= ~((uint64_t)1 << r->depth);
+    }
+    r->depth++;
+    r->phase = is_object ? JSON_EXPECT_KEY : JSON_EXPECT_VALUE;
+    r->first = true;
+
+    token->type = is_object ? JSON_TOKEN_OBJECT_BEGIN : JSON_TOKEN_ARRAY_BEGIN;
+    token->start = r->data + r->pos;
+    token->length = 1;
+    r->pos++;
+    return true;
+}
+
+static bool json_reader_close(JsonReader *r, JsonToken *token) {
+    bool is_object = json_reader_in_object(r);
+    r->depth--;
+    r->phase = JSON_EXPECT_SEPARATOR;
+    r->first = false;
+
+    token->type = is_object ? JSON_TOKEN_OBJECT_END : JSON_TOKEN_ARRAY_END;
+    token->start = r->data + r->pos;
+    token->length = 1;
+    r->pos++;
+    return true;
+}
+
+static bool json_reader_value(JsonReader *r, JsonToken *token) {
+    char c = r->data[r->pos];
+    r->first = false;
+
+    switch (c) {
+        case '{':
+            return json_reader_open(r, token, true);
+        case '[':
+            return json_reader_open(r, token, false);
+        case '"':
+            token->type = JSON_TOKEN_STRING;
+            if (!json_reader_scan_string(r, token)) {
+                return false;
+            }
+            break;
+        case 't':
+            if (!json_reader_scan_literal(r, token, "true", JSON_TOKEN_TRUE)) return false;
+            break;
+        case 'f':
+            if (!json_reader_scan_literal(r, token, "false", JSON_TOKEN_FALSE)) return false;
+            break;
+        case 'n':
+            if (!json_reader_scan_literal(r, token, "null", JSON_TOKEN_NULL)) return false;
+            break;
+        default:
+            if (!json_reader_scan_number(r, token)) return false;
+            break;
+    }
+
+    r->phase = JSON_EXPECT_SEPARATOR;
+    return true;
+}
+
+void json_reader_init(JsonReader *r, const char *data, size_t size) {
+    memset(r, 0, sizeof(*r));
+    r->data = data;
+    r->size = size;
+    r->phase = JSON_EXPECT_VALUE;
+    r->first = true;
+}
+
+bool json_reader_next(JsonReader *r, JsonToken *token) {
+    token->type = JSON_TOKEN_ERROR;
+    token->length = 0;
+    if (r->error) {
+        return false;
+    }
+
+    json_reader_skip_whitespace(r);
+
+    if (r->phase == JSON_EXPECT_SEPARATOR && r->depth == 0) {
+        if (r->pos != r->size) {
+            return json_reader_fail(r, "trailing characters after JSON value");
+        }
+        token->type = JSON_TOKEN_END;
+        token->start = r->data + r->pos;
+        return true;
+    }
+    if (r->pos >= r->size) {
+        return json_reader_fail(r, "unexpected end of input");
+    }
+
+    char c = r->data[r->pos];
+    char close = json_reader_in_object(r) ? '}' : ']';
+
+    switch (r->phase) {
+        case JSON_EXPECT_SEPARATOR:
+            if (c == close) {
+                return json_reader_close(r, token);
+            }
+            if (c != ',') {
+                return json_reader_fail(r, "expected ',' or closing bracket");
+            }
+            r->pos++;
+            r->phase = json_reader_in_object(r) ? JSON_EXPECT_KEY : JSON_EXPECT_VALUE;
+            return json_reader_next(r, token);
+
+        case JSON_EXPECT_KEY:
+            if (c == '}' && r->first) {
+                return json_reader_close(r, token);
+            }
+            if (c != '"') {
+                return json_reader_fail(r, "expected object key");
+            }
+            token->type = JSON_TOKEN_KEY;
+            if (!json_reader_scan_string(r, token)) {
+                return false;
+            }
+            json_reader_skip_whitespace(r);
+            if (r->pos >= r->size || r->data[r->pos] != ':') {
+                return json_reader_fail(r, "expected ':' after object key");
+            }
+            r->pos++;
+            r->phase = JSON_EXPECT_VALUE;
+            return true;
+
+        case JSON_EXPECT_VALUE:
+            if (c == ']' && r->first && r->depth > 0 && !json_reader_in_object(r)) {
+                return json_reader_close(r, token);
+            }
+            return json_reader_value(r, token);
+    }
+
+    return json_reader_fail(r, "invalid reader state");
+}
+
+bool json_reader_failed(const JsonReader *r) {
+    return r->error != NULL;
+}
+
+void json_reader_print_error(const JsonReader *r, const char *what) {
+    unsigned line = 1;
+    for (size_t i = 0; i < r->error_pos && i < r->size; i++) {
+        if (r->data[i] == '\n') line++;
+    }
+    fprintf(stderr, "%s: %s at line %u\n", what, r->error ? r->error : "unexpected JSON", line);
+}
+
+bool json_reader_skip(JsonReader *r, const JsonToken *token) {
+    if (token->type != JSON_TOKEN_OBJECT_BEGIN && token->type != JSON_TOKEN_ARRAY_BEGIN) {
+        return !r->error;
+    }
+
+    unsigned target_depth = r->depth - 1;
+    JsonToken t;
+    while (r->depth > target_depth) {
+        if (!json_reader_next(r, &t)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool json_reader_member(JsonReader *r, JsonToken *key, JsonToken *value) {
+    if (!json_reader_next(r, key) || key->type == JSON_TOKEN_OBJECT_END) {
+        return false;
+    }
+    if (key->type != JSON_TOKEN_KEY) {
+        return json_reader_fail(r, "expected object member");
+    }
+    return json_reader_next(r, value);
+}
+
+bool json_reader_element(JsonReader *r, JsonToken *value) {
+    if (!json_reader_next(r, value) || value->type == JSON_TOKEN_ARRAY_END) {
+        return false;
+    }
+    if (value->type == JSON_TOKEN_OBJECT_END || value->type == JSON_TOKEN_KEY) {
+        return json_reader_fail(r, "expected array element");
+    }
+    return true;
+}
+
+bool json_token_equals(const JsonToken *token, const char *text) {
+    size_t length = strlen(text);
+    return !token->escaped && token->length == length &&
+           memcmp(token->start, text, length) == 0;
+}
+
+bool json_token_unsigned(const JsonToken *token, unsigned *value) {
+    if (token->type != JSON_TOKEN_NUMBER || token->length == 0) {
+        return false;
+    }
+
+    unsigned result = 0;
+    for (size_t i = 0; i < token->length; i++) {
+        char c = token->start[i];
+        if (!json_is_digit(c)) {
+            return false; // Negative, fractional or exponent form
+        }
+        unsigned digit = (unsigned)(c - '0');
+        if (result > (UINT32_MAX - digit) / 10u) {
+            return false;
+        }
+        result = result * 10u + digit;
+    }
+
+    *value = result;
+    return true;
+}
+
+static int json_hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+static bool json_read_hex4(const char *p, const char *end, unsigned *code) {
+    if (end - p < 4) {
+        return false;
+    }
+    *code = 0;
+    for (int i = 0; i < 4; i++) {
+        int v = json_hex_value(p[i]);
+        if (v < 0) {
+            return false;
+        }
+        *code = (*code << 4) | (unsigned)v;
+    }
+    return true;
+}
+
+static size_t json_utf8_encode(unsigned code, char *out) {
+    if (code < 0x80) {
+        out[0] = (char)code;
+        return 1;
+    }
+    if (code < 0x800) {
+        out[0] = (char)(0xc0 | (code >> 6));
+        out[1] = (char)(0x80 | (code & 0x3f));
+        return 2;
+    }
+    if (code < 0x10000) {
+        out[0] = (char)(0xe0 | (code >> 12));
+        out[1] = (char)(0x80 | ((code >> 6) & 0x3f));
+        out[2] = (char)(0x80 | (code & 0x3f));
+        return 3;
+    }
+    out[0] = (char)(0xf0 | (code >> 18));
+    out[1] = (char)(0x80 | ((code >> 12) & 0x3f));
+    out[2] = (char)(0x80 | ((code >> 6) & 0x3f));
+    out[3] = (char)(0x80 | (code & 0x3f));
+    return 4;
+}
+
+bool json_token_copy_string(const JsonToken *token, char *dst, size_t dst_size) {
+    if ((token->type != JSON_TOKEN_STRING && token->type != JSON_TOKEN_KEY) || dst_size == 0) {
+        return false;
+    }
+
+    if (!token->escaped) {
+        if (token->length >= dst_size) {
+            return false;
+        }
+        memcpy(dst, token->start, token->length);
+        dst[token->length] = '\0';
+        return true;
+    }
+
+    const char *p = token->start;
+    const char *end = token->start + token->length;
+    size_t out = 0;
+    while (p < end) {
+        char encoded[4];
+        size_t n = 1;
+        encoded[0] = *p++;
+
+        if (encoded[0] == '\\') {
+            char e = *p++;
+            switch (e) {
+                case '"': case '\\': case '/': encoded[0] = e; break;
+                case 'b': encoded[0] = '\b'; break;
+                case 'f': encoded[0] = '\f'; break;
+                case 'n': encoded[0] = '\n'; break;
+                case 'r': encoded[0] = '\r'; break;
+                case 't': encoded[0] = '\t'; break;
+                case 'u': {
+                    unsigned code;
+                    if (!json_read_hex4(p, end, &code)) {
+                        return false;
+                    }
+                    p += 4;
+                    // Combine a UTF-16 surrogate pair into one code point
+                    if (code >= 0xd800 && code < 0xdc00) {
+                        unsigned low;
+                        if (end - p < 6 || p[0] != '\\' || p[1] != 'u' ||
+                            !json_read_hex4(p + 2, end, &low) || low < 0xdc00 || low >= 0xe000) {
+                            return false;
+                        }
+                        p += 6;
+                        code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+                    }
+                    n = json_utf8_encode(code, encoded);
+                    break;
+                }
+                default:
+                    return false;
+            }
+        }
+
+        if (out + n >= dst_size) {
+            return false;
+        }
+        memcpy(dst + out, encoded, n);
+        out += n;
+    }
+
+    dst[out] = '\0';
+    return true;
+}
@@ -0,0 +1,84 @@
+#ifndef JSON_READER_H
+#define JSON_READER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Streaming pull tokenizer for JSON held in memory. It makes one forward pass
+// over the text and never allocates: tokens point back into the input, and
+// strings are only decoded when the caller copies them into its own buffer.
+//
+// Typical use walks objects and arrays with json_reader_member() and
+// json_reader_element(), handling the keys it knows and passing everything
+// else to json_reader_skip(). Any syntax error stops the reader; check
+// json_reader_failed() once at the end.
+#define JSON_READER_MAX_DEPTH 64
+
+typedef enum {
+    JSON_TOKEN_ERROR = 0,
+    JSON_TOKEN_OBJECT_BEGIN,
+    JSON_TOKEN_OBJECT_END,
+    JSON_TOKEN_ARRAY_BEGIN,
+    JSON_TOKEN_ARRAY_END,
+    JSON_TOKEN_KEY,
+    JSON_TOKEN_STRING,
+    JSON_TOKEN_NUMBER,
+    JSON_TOKEN_TRUE,
+    JSON_TOKEN_FALSE,
+    JSON_TOKEN_NULL,
+    JSON_TOKEN_END              // End of input after the top-level value
+} JsonTokenType;
+
+typedef struct {
+    JsonTokenType type;
+    const char *start;          // Strings and keys exclude the quotes
+    size_t length;
+    bool escaped;               // String contains backslash escapes
+} JsonToken;
+
+typedef enum {
+    JSON_EXPECT_VALUE,
+    JSON_EXPECT_KEY,
+    JSON_EXPECT_SEPARATOR
+} JsonReaderPhase;
+
+typedef struct {
+    const char *data;
+    size_t size;
+    size_t pos;
+    unsigned depth;
+    uint64_t object_mask;       // Bit d set when the container at depth d is an object
+    JsonReaderPhase phase;
+    bool first;                 // No member or element read yet in the open container
+    const char *error;          // First error, NULL while the input is valid
+    size_t error_pos;
+} JsonReader;
+
+void json_reader_init(JsonReader *r, const char *data, size_t size);
+bool json_reader_next(JsonReader *r, JsonToken *token);
+bool json_reader_failed(const JsonReader *r);
+
+// Reports the first error, with its line number, prefixed by what was parsed
+void json_reader_print_error(const JsonReader *r, const char *what);
+
+// Skips the rest of the value that starts with token, including any nested
+// objects or arrays.
+bool json_reader_skip(JsonReader *r, const JsonToken *token);
+
+// Reads the next member of the object that is currently open. Returns false
+// once the closing brace is consumed or on error.
+bool json_reader_member(JsonReader *r, JsonToken *key, JsonToken *value);
+
+// Reads the next element of the array that is currently open. Returns false
+// once the closing bracket is consumed or on error.
+bool json_reader_element(JsonReader *r, JsonToken *value);
+
+bool json_token_equals(const JsonToken *token, const char *text);
+bool json_token_unsigned(const JsonToken *token, unsigned *value);
+
+// Decodes a string token into dst. Fails without truncating when the decoded
+// string and its terminator do not fit in dst_size bytes.
+bool json_token_copy_string(const JsonToken *token, char *dst, size_t dst_size);
+
+#endif
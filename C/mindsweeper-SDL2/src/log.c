@@ -0,0 +1,126 @@
+#include "log.h"
+#include <SDL2/SDL.h>
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdio.h>
+
+// Bounded multi-producer ring. Each slot's sequence encodes its state for the
+// lap that position pos is on: 2 * lap when free, 2 * lap + 1 once written.
+// Zero-initialised slots are therefore free for the first lap.
+typedef struct {
+    atomic_size_t sequence;
+    LogLevel level;
+    LogCategory category;
+    char text[LOG_MESSAGE_SIZE];
+} LogSlot;
+
+static LogSlot log_ring[LOG_RING_SIZE];
+static atomic_size_t log_head;          // Next position to write
+static size_t log_tail;                 // Next position to flush, flusher only
+static atomic_uint log_dropped;         // Messages lost to a full ring
+
+#ifndef WASM_BUILD
+static SDL_Thread *log_thread = NULL;
+static atomic_bool log_running;
+#endif
+
+static const char *const log_level_names[] = {"DEBUG", "INFO", "WARN", "ERROR"};
+static const char *const log_category_names[LOG_CAT_COUNT] = {
+    "game", "board", "click", "anim", "config", "admin"
+};
+
+void log_write(LogLevel level, LogCategory category, const char *format, ...) {
+    size_t pos = atomic_load_explicit(&log_head, memory_order_relaxed);
+
+    for (;;) {
+        LogSlot *slot = &log_ring[pos & (LOG_RING_SIZE - 1)];
+        size_t free_mark = pos / LOG_RING_SIZE * 2;
+        size_t sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+
+        if (sequence == free_mark) {
+            if (atomic_compare_exchange_weak_explicit(&log_head, &pos, pos + 1,
+                                                      memory_order_relaxed,
+                                                      memory_order_relaxed)) {
+                slot->level = level;
+                slot->category = category;
+
+                va_list args;
+                va_start(args, format);
+                vsnprintf(slot->text, sizeof(slot->text), format, args);
+                va_end(args);
+
+                atomic_store_explicit(&slot->sequence, free_mark + 1, memory_order_release);
+                return;
+            }
+        } else if (sequence < free_mark) {
+            // The flusher has not reached this slot's previous message yet
+            atomic_fetch_add_explicit(&log_dropped, 1, memory_order_relaxed);
+            return;
+        } else {
+            pos = atomic_load_explicit(&log_head, memory_order_relaxed);
+        }
+    }
+}
+
+void log_flush(void) {
+    bool wrote_stdout = false;
+
+    for (;;) {
+        LogSlot *slot = &log_ring[log_tail & (LOG_RING_SIZE - 1)];
+        size_t written_mark = log_tail / LOG_RING_SIZE * 2 + 1;
+        if (atomic_load_explicit(&slot->sequence, memory_order_acquire) != written_mark) {
+            break;
+        }
+
+        FILE *stream = slot->level >= LOG_LEVEL_WARN ? stderr : stdout;
+        fprintf(stream, "[%s][%s] %s\n", log_level_names[slot->level],
+                log_category_names[slot->category], slot->text);
+        wrote_stdout |= stream == stdout;
+
+        atomic_store_explicit(&slot->sequence, written_mark + 1, memory_order_release);
+        log_tail++;
+    }
+
+    unsigned dropped = atomic_exchange_explicit(&log_dropped, 0, memory_order_relaxed);
+    if (dropped > 0) {
+        fprintf(stderr, "[WARN][log] %u messages dropped, ring buffer full\n", dropped);
+    }
+    if (wrote_stdout) {
+        fflush(stdout);
+    }
+}
+
+#ifndef WASM_BUILD
+static int log_flush_thread(void *data) {
+    (void)data;
+    while (atomic_load(&log_running)) {
+        log_flush();
+        SDL_Delay(LOG_FLUSH_INTERVAL_MS);
+    }
+    return 0;
+}
+#endif
+
+bool log_init(void) {
+#ifndef WASM_BUILD
+    atomic_store(&log_running, true);
+    log_thread = SDL_CreateThread(log_flush_thread, "log", NULL);
+    if (!log_thread) {
+        fprintf(stderr, "Error creating log thread: %s\n", SDL_GetError());
+        atomic_store(&log_running, false);
+        return false;
+    }
+#endif
+    return true;
+}
+
+void log_shutdown(void) {
+#ifndef WASM_BUILD
+    if (log_thread) {
+        atomic_store(&log_running, false);
+        SDL_WaitThread(log_thread, NULL);
+        log_thread = NULL;
+    }
+#endif
+    log_flush();
+}
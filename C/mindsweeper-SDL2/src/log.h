@@ -0,0 +1,69 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <stdbool.h>
+
+// Levelled, categorised logging into an in-memory ring buffer. Writers only
+// format into a free slot; the text reaches stdout/stderr when log_flush()
+// runs, which is a background thread on native builds and the end of each
+// frame under WASM. Nothing on the click, animation or load paths waits on
+// terminal or console I/O.
+//
+// Levels below LOG_LEVEL_FLOOR and categories outside LOG_CATEGORIES are
+// removed at compile time, so `make release` carries no debug logging.
+typedef enum {
+    LOG_LEVEL_DEBUG = 0,
+    LOG_LEVEL_INFO,
+    LOG_LEVEL_WARN,             // WARN and ERROR are flushed to stderr
+    LOG_LEVEL_ERROR
+} LogLevel;
+
+typedef enum {
+    LOG_CAT_GAME = 0,
+    LOG_CAT_BOARD,
+    LOG_CAT_CLICK,
+    LOG_CAT_ANIM,
+    LOG_CAT_CONFIG,
+    LOG_CAT_ADMIN,
+    LOG_CAT_COUNT
+} LogCategory;
+
+#ifndef LOG_LEVEL_FLOOR
+#define LOG_LEVEL_FLOOR LOG_LEVEL_DEBUG
+#endif
+
+#ifndef LOG_CATEGORIES
+#define LOG_CATEGORIES (~0u)    // Bit per LogCategory
+#endif
+
+#define LOG_RING_SIZE 256       // Slots, power of two
+#define LOG_MESSAGE_SIZE 192    // Longer messages are truncated
+#define LOG_FLUSH_INTERVAL_MS 50
+
+#if defined(__GNUC__)
+__attribute__((format(printf, 3, 4)))
+#endif
+void log_write(LogLevel level, LogCategory category, const char *format, ...);
+
+// Starts the background flush thread on native builds
+bool log_init(void);
+// Writes out everything queued so far. Only one thread may flush at a time.
+void log_flush(void);
+// Stops the flush thread and writes out what is left
+void log_shutdown(void);
+
+// The call stays visible to the compiler so arguments count as used, but a
+// constant-false condition removes it and its format string from the build.
+#define LOG_AT(level, category, ...) \
+    do { \
+        if ((level) >= LOG_LEVEL_FLOOR && (LOG_CATEGORIES & (1u << (category)))) { \
+            log_write((level), (category), __VA_ARGS__); \
+        } \
+    } while (0)
+
+#define LOG_DEBUG(category, ...) LOG_AT(LOG_LEVEL_DEBUG, category, __VA_ARGS__)
+#define LOG_INFO(category, ...) LOG_AT(LOG_LEVEL_INFO, category, __VA_ARGS__)
+#define LOG_WARN(category, ...) LOG_AT(LOG_LEVEL_WARN, category, __VA_ARGS__)
+#define LOG_ERROR(category, ...) LOG_AT(LOG_LEVEL_ERROR, category, __VA_ARGS__)
+
+#endif
@@ -1,13 +1,14 @@
 #include "game.h"
-#include <time.h>
+#include "log.h"
 #include <stdlib.h>
 
 int main(void) {
-    // Initialize random seed
-    srand((unsigned)time(NULL));
-    
     bool exit_status = EXIT_FAILURE;
 
+    if (!log_init()) {
+        return exit_status;
+    }
+
     struct Game *game = NULL;
 
     if (game_new(&game)) {
@@ -17,6 +18,7 @@ int main(void) {
     }
 
     game_free(&game);
+    log_shutdown();
 
     return exit_status;
 }
@@ -20,6 +20,14 @@
 #define WINDOW_WIDTH 1200  // Reduced from 1440 to 1200 for better fit
 #define WINDOW_HEIGHT 920  // Keep height the same for player panel visibility
 
+// Frame pacing: with vsync SDL_RenderPresent waits for the display, otherwise
+// animation frames are spaced GAME_FRAME_MS apart. Build with -DGAME_VSYNC=0
+// to turn vsync off.
+#ifndef GAME_VSYNC
+#define GAME_VSYNC 1
+#endif
+#define GAME_FRAME_MS 16
+
 #define PIECE_SIZE 16    // Back to original sprite size
 #define BORDER_HEIGHT 55
 #define BORDER_LEFT 4
@@ -57,12 +65,20 @@
 #define DEFAULT_BOARD_COLS 14    // Back to original  
 // DEFAULT_SCALE removed - will be calculated dynamically
 
+// Entity definitions and starting stats
+#define GAME_CONFIG_FILE "config_v2.json"
+
+// Binary solution pack generated from latest-s-v0_0_9.json by `make pack`
+#define SOLUTION_PACK_FILE "latest-s-v0_0_9.pack"
+
 // Function to calculate optimal scale based on window dimensions
 int calculate_optimal_scale(int window_width, int window_height, int board_rows, int board_cols);
 
 // Animation constants
 #define ANIM_REVEALING_DURATION_MS 800
 #define ANIM_COMBAT_DURATION_MS 500
+#define ANIM_COMBAT_STAGE2_DURATION_MS 500
+#define ANIM_TRANSITION_DURATION_MS 500
 #define ANIM_TREASURE_DURATION_MS 300
 
 // Player progression constants
@@ -80,10 +96,9 @@ int calculate_optimal_scale(int window_width, int window_height, int board_rows,
 // String buffer sizes
 #define MAX_ENTITY_NAME 64
 #define MAX_ENTITY_DESCRIPTION 256
-#define MAX_UUID_LENGTH 64
 #define MAX_SOUND_NAME 32
 #define MAX_TITLE_LENGTH 256
 #define MAX_ENTITY_TAGS 10
-#define MAX_TAG_LENGTH 32
+#define MAX_TAG_LENGTH 48
 
 #endif
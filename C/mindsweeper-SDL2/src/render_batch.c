@@ -0,0 +1,128 @@
+#include "render_batch.h"
+#include <limits.h>
+#include <string.h>
+
+void render_batch_free(RenderBatch *batch) {
+    if (batch->vertices) {
+        free(batch->vertices);
+        batch->vertices = NULL;
+    }
+    if (batch->indices) {
+        free(batch->indices);
+        batch->indices = NULL;
+    }
+    batch->texture = NULL;
+    batch->quad_count = 0;
+    batch->capacity = 0;
+}
+
+void render_batch_begin(RenderBatch *batch, SDL_Texture *texture) {
+    batch->texture = texture;
+    batch->quad_count = 0;
+    batch->inv_w = 0.0f;
+    batch->inv_h = 0.0f;
+
+    int w = 0, h = 0;
+    if (texture && SDL_QueryTexture(texture, NULL, NULL, &w, &h) == 0 && w > 0 && h > 0) {
+        batch->inv_w = 1.0f / (float)w;
+        batch->inv_h = 1.0f / (float)h;
+    }
+}
+
+static bool render_batch_grow(RenderBatch *batch) {
+    unsigned capacity = batch->capacity ? batch->capacity * 2 : 256;
+    // SDL_RenderGeometry takes int counts
+    if (capacity > (unsigned)(INT_MAX / 6)) {
+        fprintf(stderr, "Render batch cannot hold %u quads\n", capacity);
+        return false;
+    }
+
+    SDL_Vertex *vertices = realloc(batch->vertices, (size_t)capacity * 4 * sizeof(SDL_Vertex));
+    if (!vertices) {
+        fprintf(stderr, "Error in realloc of render batch vertices.\n");
+        return false;
+    }
+    batch->vertices = vertices;
+
+    int *indices = realloc(batch->indices, (size_t)capacity * 6 * sizeof(int));
+    if (!indices) {
+        fprintf(stderr, "Error in realloc of render batch indices.\n");
+        return false;
+    }
+    batch->indices = indices;
+
+    // Two triangles per quad: top-left, top-right, bottom-left, bottom-right
+    for (unsigned q = batch->capacity; q < capacity; q++) {
+        int v = (int)q * 4;
+        int *i = indices + (size_t)q * 6;
+        i[0] = v;
+        i[1] = v + 1;
+        i[2] = v + 2;
+        i[3] = v + 2;
+        i[4] = v + 1;
+        i[5] = v + 3;
+    }
+    batch->capacity = capacity;
+    return true;
+}
+
+bool render_batch_add(RenderBatch *batch, const SDL_Rect *src, const SDL_Rect *dst, SDL_Color color) {
+    if (batch->quad_count == batch->capacity && !render_batch_grow(batch)) {
+        return false;
+    }
+
+    render_batch_set(batch, batch->quad_count++, src, dst, color);
+    return true;
+}
+
+bool render_batch_resize(RenderBatch *batch, unsigned count) {
+    while (batch->capacity < count) {
+        if (!render_batch_grow(batch)) {
+            return false;
+        }
+    }
+
+    // Zero-area quads draw nothing
+    if (count > 0) {
+        memset(batch->vertices, 0, (size_t)count * 4 * sizeof(SDL_Vertex));
+    }
+    batch->quad_count = count;
+    return true;
+}
+
+void render_batch_set(RenderBatch *batch, unsigned quad, const SDL_Rect *src, const SDL_Rect *dst,
+                      SDL_Color color) {
+    SDL_Vertex *v = batch->vertices + (size_t)quad * 4;
+    if (!dst) {
+        memset(v, 0, 4 * sizeof(SDL_Vertex));
+        return;
+    }
+
+    float x0 = (float)dst->x;
+    float y0 = (float)dst->y;
+    float x1 = (float)(dst->x + dst->w);
+    float y1 = (float)(dst->y + dst->h);
+
+    float u0 = 0.0f, v0 = 0.0f, u1 = 0.0f, v1 = 0.0f;
+    if (src) {
+        u0 = (float)src->x * batch->inv_w;
+        v0 = (float)src->y * batch->inv_h;
+        u1 = (float)(src->x + src->w) * batch->inv_w;
+        v1 = (float)(src->y + src->h) * batch->inv_h;
+    }
+
+    v[0] = (SDL_Vertex){{x0, y0}, color, {u0, v0}};
+    v[1] = (SDL_Vertex){{x1, y0}, color, {u1, v0}};
+    v[2] = (SDL_Vertex){{x0, y1}, color, {u0, v1}};
+    v[3] = (SDL_Vertex){{x1, y1}, color, {u1, v1}};
+}
+
+void render_batch_draw(const RenderBatch *batch, SDL_Renderer *renderer) {
+    if (batch->quad_count == 0) {
+        return;
+    }
+    if (SDL_RenderGeometry(renderer, batch->texture, batch->vertices, (int)batch->quad_count * 4,
+                           batch->indices, (int)batch->quad_count * 6) != 0) {
+        fprintf(stderr, "Error drawing render batch: %s\n", SDL_GetError());
+    }
+}
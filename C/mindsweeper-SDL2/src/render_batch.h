@@ -0,0 +1,39 @@
+#ifndef RENDER_BATCH_H
+#define RENDER_BATCH_H
+
+#include "main.h"
+
+// Axis-aligned quads from one texture, or solid-colour quads, submitted with
+// a single SDL_RenderGeometry call. Quads are drawn in the order they were
+// added. The buffers keep their capacity when the batch is refilled, so once
+// a batch has grown to the board's size rebuilding it does not allocate.
+typedef struct {
+    SDL_Texture *texture;       // NULL for solid-colour quads
+    float inv_w;                // 1 / texture width, for texture coordinates
+    float inv_h;
+    SDL_Vertex *vertices;       // 4 per quad
+    int *indices;               // 6 per quad, fixed once allocated
+    unsigned quad_count;
+    unsigned capacity;          // Quads the buffers can hold
+} RenderBatch;
+
+void render_batch_free(RenderBatch *batch);
+
+// Empties the batch and binds it to texture (NULL for solid colour)
+void render_batch_begin(RenderBatch *batch, SDL_Texture *texture);
+
+// Adds src of the batch texture drawn to dst, or a solid dst when src is NULL.
+// Textured quads are tinted by color like SDL_SetTextureColorMod.
+bool render_batch_add(RenderBatch *batch, const SDL_Rect *src, const SDL_Rect *dst, SDL_Color color);
+
+// Sizes the batch to count empty quads, so each can be set in place later,
+// e.g. one slot per tile that is patched when the tile changes
+bool render_batch_resize(RenderBatch *batch, unsigned count);
+
+// Overwrites quad like render_batch_add would draw it; a NULL dst empties it
+void render_batch_set(RenderBatch *batch, unsigned quad, const SDL_Rect *src, const SDL_Rect *dst,
+                      SDL_Color color);
+
+void render_batch_draw(const RenderBatch *batch, SDL_Renderer *renderer);
+
+#endif
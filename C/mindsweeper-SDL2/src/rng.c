@@ -0,0 +1,20 @@
+#include "rng.h"
+#include <time.h>
+
+void rng_seed(Rng *rng, uint64_t seed, uint64_t stream) {
+    rng->state = 0;
+    rng->increment = (stream << 1) | 1u;
+    rng_next(rng);
+    rng->state += seed;
+    rng_next(rng);
+}
+
+uint64_t rng_entropy_seed(void) {
+    // Wall clock and CPU time, mixed (splitmix64) so close start times
+    // still give unrelated seeds
+    uint64_t x = (uint64_t)time(NULL) ^ ((uint64_t)clock() << 32);
+    x += 0x9e3779b97f4a7c15ull;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
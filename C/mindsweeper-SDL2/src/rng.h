@@ -0,0 +1,46 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <stdint.h>
+
+// PCG32 (XSH RR): 64-bit state, 32-bit output. A generator is a plain value
+// owned by whoever draws from it, so each game or simulation thread has its
+// own stream, needs no lock and replays exactly from its seed.
+typedef struct {
+    uint64_t state;
+    uint64_t increment;  // Odd; selects one of 2^63 independent streams
+} Rng;
+
+void rng_seed(Rng *rng, uint64_t seed, uint64_t stream);
+// Seed for a new session when none was asked for
+uint64_t rng_entropy_seed(void);
+
+static inline uint32_t rng_next(Rng *rng) {
+    uint64_t old = rng->state;
+    rng->state = old * 6364136223846793005ull + rng->increment;
+    uint32_t xorshifted = (uint32_t)(((old >> 18) ^ old) >> 27);
+    unsigned rotation = (unsigned)(old >> 59);
+    return (xorshifted >> rotation) | (xorshifted << ((32u - rotation) & 31u));
+}
+
+static inline uint64_t rng_next64(Rng *rng) {
+    uint64_t high = rng_next(rng);
+    return (high << 32) | rng_next(rng);
+}
+
+// Uniform in [0, bound) without modulo bias (Lemire's multiply-and-reject).
+// bound must be non-zero.
+static inline uint32_t rng_below(Rng *rng, uint32_t bound) {
+    uint64_t product = (uint64_t)rng_next(rng) * bound;
+    uint32_t low = (uint32_t)product;
+    if (low < bound) {
+        uint32_t threshold = (uint32_t)(-bound) % bound;
+        while (low < threshold) {
+            product = (uint64_t)rng_next(rng) * bound;
+            low = (uint32_t)product;
+        }
+    }
+    return (uint32_t)(product >> 32);
+}
+
+#endif
@@ -0,0 +1,91 @@
+#include "solution_catalog.h"
+#include <stdlib.h>
+#include <string.h>
+
+bool solution_catalog_open(SolutionCatalog *catalog, const char *pack_file) {
+    memset(catalog, 0, sizeof(*catalog));
+
+#if !defined(WASM_BUILD) && !defined(_WIN32)
+    if (!solution_store_open(&catalog->store, pack_file)) {
+        return false;
+    }
+    catalog->header = &catalog->store.header;
+#else
+    if (!solution_pack_open(&catalog->pack, pack_file)) {
+        return false;
+    }
+    catalog->header = &catalog->pack.header;
+
+    catalog->uuids = malloc((size_t)catalog->header->board_count * catalog->header->uuid_size);
+    if (!catalog->uuids) {
+        fprintf(stderr, "Error in malloc of solution UUID table.\n");
+        solution_catalog_close(catalog);
+        return false;
+    }
+    if (!solution_pack_read_uuid_table(&catalog->pack, catalog->uuids)) {
+        fprintf(stderr, "Invalid solution pack: %s\n", pack_file);
+        solution_catalog_close(catalog);
+        return false;
+    }
+#endif
+
+    return true;
+}
+
+void solution_catalog_close(SolutionCatalog *catalog) {
+#if !defined(WASM_BUILD) && !defined(_WIN32)
+    solution_store_close(&catalog->store);
+#else
+    solution_pack_close(&catalog->pack);
+    if (catalog->uuids) {
+        free(catalog->uuids);
+        catalog->uuids = NULL;
+    }
+#endif
+    catalog->header = NULL;
+}
+
+unsigned solution_catalog_count(const SolutionCatalog *catalog) {
+    return catalog->header ? catalog->header->board_count : 0;
+}
+
+const char *solution_catalog_uuid(const SolutionCatalog *catalog, unsigned index) {
+    if (index >= solution_catalog_count(catalog)) {
+        return NULL;
+    }
+
+#if !defined(WASM_BUILD) && !defined(_WIN32)
+    SolutionView view;
+    return solution_store_get(&catalog->store, index, &view) ? view.uuid : NULL;
+#else
+    return catalog->uuids + (size_t)index * catalog->header->uuid_size;
+#endif
+}
+
+bool solution_catalog_board(SolutionCatalog *catalog, unsigned index,
+                            unsigned rows, unsigned cols, unsigned *entity_ids) {
+    if (!catalog->header) {
+        fprintf(stderr, "Solution catalog is not open\n");
+        return false;
+    }
+    if (catalog->header->rows != rows || catalog->header->cols != cols) {
+        fprintf(stderr, "Solution size (%ux%u) doesn't match board size (%ux%u)\n",
+                catalog->header->rows, catalog->header->cols, rows, cols);
+        return false;
+    }
+
+#if !defined(WASM_BUILD) && !defined(_WIN32)
+    SolutionView view;
+    if (!solution_store_get(&catalog->store, index, &view)) {
+        return false;
+    }
+
+    size_t cells = (size_t)rows * cols;
+    for (size_t i = 0; i < cells; i++) {
+        entity_ids[i] = solution_pack_cell(view.cells, i);
+    }
+    return true;
+#else
+    return solution_pack_read_board(&catalog->pack, index, entity_ids);
+#endif
+}
@@ -0,0 +1,32 @@
+#ifndef SOLUTION_CATALOG_H
+#define SOLUTION_CATALOG_H
+
+#include "solution_pack.h"
+#if !defined(WASM_BUILD) && !defined(_WIN32)
+#include "solution_store.h"
+#endif
+
+// Every solution in one pack, opened once at startup and kept for the life of
+// the game. POSIX builds serve boards from the mapped pack; WASM and Windows
+// builds keep the pack stream open and the UUID table in memory.
+typedef struct {
+#if !defined(WASM_BUILD) && !defined(_WIN32)
+    SolutionStore store;
+#else
+    SolutionPack pack;
+    char *uuids;                // board_count x uuid_size, NUL terminated entries
+#endif
+    const SolutionPackHeader *header;
+} SolutionCatalog;
+
+bool solution_catalog_open(SolutionCatalog *catalog, const char *pack_file);
+void solution_catalog_close(SolutionCatalog *catalog);
+unsigned solution_catalog_count(const SolutionCatalog *catalog);
+const char *solution_catalog_uuid(const SolutionCatalog *catalog, unsigned index);
+
+// Writes the rows x cols entity IDs of board index into entity_ids. Fails if
+// the pack boards have a different size.
+bool solution_catalog_board(SolutionCatalog *catalog, unsigned index,
+                            unsigned rows, unsigned cols, unsigned *entity_ids);
+
+#endif
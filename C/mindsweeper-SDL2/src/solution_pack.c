@@ -0,0 +1,259 @@
+#include "solution_pack.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Header layout (SOLUTION_PACK_HEADER_SIZE bytes):
+//   0  char[4] magic      16 uint32 uuid_size
+//   4  uint32  version    20 uint32 index_offset
+//   8  uint32  boards     24 uint32 uuid_offset
+//  12  uint16  rows       28 uint32 boards_offset
+//  14  uint16  cols
+
+static uint16_t read_u16le(const uint8_t *p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static void write_u16le(uint8_t *p, uint16_t value) {
+    p[0] = (uint8_t)(value & 0xff);
+    p[1] = (uint8_t)(value >> 8);
+}
+
+static void write_u32le(uint8_t *p, uint32_t value) {
+    p[0] = (uint8_t)(value & 0xff);
+    p[1] = (uint8_t)((value >> 8) & 0xff);
+    p[2] = (uint8_t)((value >> 16) & 0xff);
+    p[3] = (uint8_t)(value >> 24);
+}
+
+bool solution_pack_parse_header(const uint8_t *raw, SolutionPackHeader *h) {
+    if (memcmp(raw, SOLUTION_PACK_MAGIC, 4) != 0 ||
+        solution_pack_u32(raw + 4) != SOLUTION_PACK_VERSION) {
+        fprintf(stderr, "Not a version %u solution pack\n", SOLUTION_PACK_VERSION);
+        return false;
+    }
+
+    h->board_count = solution_pack_u32(raw + 8);
+    h->rows = read_u16le(raw + 12);
+    h->cols = read_u16le(raw + 14);
+    h->uuid_size = solution_pack_u32(raw + 16);
+    h->index_offset = solution_pack_u32(raw + 20);
+    h->uuid_offset = solution_pack_u32(raw + 24);
+    h->boards_offset = solution_pack_u32(raw + 28);
+
+    if (h->board_count == 0 || h->rows == 0 || h->cols == 0 || h->uuid_size == 0) {
+        fprintf(stderr, "Empty solution pack\n");
+        return false;
+    }
+
+    return true;
+}
+
+size_t solution_pack_record_size(const SolutionPackHeader *h) {
+    return (size_t)h->rows * h->cols * sizeof(uint16_t);
+}
+
+bool solution_pack_open(SolutionPack *pack, const char *pack_file) {
+    memset(pack, 0, sizeof(*pack));
+
+    pack->file = fopen(pack_file, "rb");
+    if (!pack->file) {
+        fprintf(stderr, "Failed to open solution pack: %s\n", pack_file);
+        return false;
+    }
+
+    uint8_t raw[SOLUTION_PACK_HEADER_SIZE];
+    if (fread(raw, 1, sizeof(raw), pack->file) != sizeof(raw)) {
+        fprintf(stderr, "Truncated solution pack header: %s\n", pack_file);
+        goto cleanup_failure;
+    }
+
+    if (!solution_pack_parse_header(raw, &pack->header)) {
+        fprintf(stderr, "Invalid solution pack: %s\n", pack_file);
+        goto cleanup_failure;
+    }
+
+    SolutionPackHeader *h = &pack->header;
+    size_t index_bytes = (size_t)h->board_count * sizeof(uint32_t);
+    uint8_t *raw_index = malloc(index_bytes);
+    pack->board_offsets = calloc(h->board_count, sizeof(uint32_t));
+    pack->record = malloc(solution_pack_record_size(h));
+    if (!raw_index || !pack->board_offsets || !pack->record) {
+        fprintf(stderr, "Error in malloc of solution pack index.\n");
+        free(raw_index);
+        goto cleanup_failure;
+    }
+
+    if (fseek(pack->file, (long)h->index_offset, SEEK_SET) != 0 ||
+        fread(raw_index, 1, index_bytes, pack->file) != index_bytes) {
+        fprintf(stderr, "Truncated solution pack index: %s\n", pack_file);
+        free(raw_index);
+        goto cleanup_failure;
+    }
+
+    for (unsigned i = 0; i < h->board_count; i++) {
+        pack->board_offsets[i] = solution_pack_u32(raw_index + (size_t)i * sizeof(uint32_t));
+    }
+    free(raw_index);
+
+    return true;
+
+cleanup_failure:
+    solution_pack_close(pack);
+    return false;
+}
+
+void solution_pack_close(SolutionPack *pack) {
+    if (pack->file) {
+        fclose(pack->file);
+        pack->file = NULL;
+    }
+    if (pack->board_offsets) {
+        free(pack->board_offsets);
+        pack->board_offsets = NULL;
+    }
+    if (pack->record) {
+        free(pack->record);
+        pack->record = NULL;
+    }
+    memset(&pack->header, 0, sizeof(pack->header));
+}
+
+bool solution_pack_read_board(SolutionPack *pack, unsigned index, unsigned *entity_ids) {
+    if (index >= pack->header.board_count) {
+        fprintf(stderr, "Solution index %u out of range (0-%u)\n",
+                index, pack->header.board_count - 1);
+        return false;
+    }
+
+    size_t record_size = solution_pack_record_size(&pack->header);
+    if (fseek(pack->file, (long)pack->board_offsets[index], SEEK_SET) != 0 ||
+        fread(pack->record, 1, record_size, pack->file) != record_size) {
+        fprintf(stderr, "Truncated board record %u in solution pack\n", index);
+        return false;
+    }
+
+    size_t cells = (size_t)pack->header.rows * pack->header.cols;
+    for (size_t i = 0; i < cells; i++) {
+        entity_ids[i] = solution_pack_cell(pack->record, i);
+    }
+
+    return true;
+}
+
+bool solution_pack_read_uuid(SolutionPack *pack, unsigned index, char *uuid, size_t uuid_size) {
+    if (index >= pack->header.board_count || uuid_size == 0) {
+        return false;
+    }
+
+    size_t read_size = pack->header.uuid_size < uuid_size - 1 ? pack->header.uuid_size : uuid_size - 1;
+    long offset = (long)pack->header.uuid_offset + (long)index * (long)pack->header.uuid_size;
+    if (fseek(pack->file, offset, SEEK_SET) != 0 ||
+        fread(uuid, 1, read_size, pack->file) != read_size) {
+        fprintf(stderr, "Truncated UUID %u in solution pack\n", index);
+        return false;
+    }
+    uuid[read_size] = '\0';
+
+    return true;
+}
+
+bool solution_pack_read_uuid_table(SolutionPack *pack, char *uuids) {
+    const SolutionPackHeader *h = &pack->header;
+    size_t table_size = (size_t)h->board_count * h->uuid_size;
+    if (fseek(pack->file, (long)h->uuid_offset, SEEK_SET) != 0 ||
+        fread(uuids, 1, table_size, pack->file) != table_size) {
+        fprintf(stderr, "Truncated UUID table in solution pack\n");
+        return false;
+    }
+
+    for (unsigned i = 0; i < h->board_count; i++) {
+        if (uuids[(size_t)(i + 1) * h->uuid_size - 1] != '\0') {
+            fprintf(stderr, "UUID %u in solution pack is not terminated\n", i);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool solution_pack_write(const char *pack_file, unsigned board_count,
+                         unsigned rows, unsigned cols,
+                         const char *const *uuids, const unsigned *entity_ids) {
+    if (board_count == 0 || rows == 0 || cols == 0 || rows > UINT16_MAX || cols > UINT16_MAX) {
+        fprintf(stderr, "Invalid solution pack dimensions\n");
+        return false;
+    }
+
+    SolutionPackHeader h = {
+        .board_count = board_count,
+        .rows = rows,
+        .cols = cols,
+        .uuid_size = SOLUTION_PACK_UUID_SIZE,
+    };
+    size_t record_size = solution_pack_record_size(&h);
+    size_t cells = (size_t)rows * cols;
+    h.index_offset = SOLUTION_PACK_HEADER_SIZE;
+    h.uuid_offset = h.index_offset + (uint32_t)(board_count * sizeof(uint32_t));
+    h.boards_offset = h.uuid_offset + board_count * h.uuid_size;
+
+    size_t total_size = h.boards_offset + (size_t)board_count * record_size;
+    if (total_size > UINT32_MAX) {
+        fprintf(stderr, "Solution pack would exceed 4 GiB\n");
+        return false;
+    }
+
+    uint8_t *data = calloc(total_size, 1);
+    if (!data) {
+        fprintf(stderr, "Error in calloc of solution pack buffer.\n");
+        return false;
+    }
+
+    memcpy(data, SOLUTION_PACK_MAGIC, 4);
+    write_u32le(data + 4, SOLUTION_PACK_VERSION);
+    write_u32le(data + 8, h.board_count);
+    write_u16le(data + 12, (uint16_t)h.rows);
+    write_u16le(data + 14, (uint16_t)h.cols);
+    write_u32le(data + 16, h.uuid_size);
+    write_u32le(data + 20, h.index_offset);
+    write_u32le(data + 24, h.uuid_offset);
+    write_u32le(data + 28, h.boards_offset);
+
+    for (unsigned i = 0; i < board_count; i++) {
+        uint32_t record_offset = h.boards_offset + (uint32_t)(i * record_size);
+        write_u32le(data + h.index_offset + (size_t)i * sizeof(uint32_t), record_offset);
+
+        size_t uuid_len = strlen(uuids[i]);
+        if (uuid_len >= h.uuid_size) {
+            fprintf(stderr, "UUID of board %u is longer than %u bytes\n", i, h.uuid_size - 1);
+            free(data);
+            return false;
+        }
+        memcpy(data + h.uuid_offset + (size_t)i * h.uuid_size, uuids[i], uuid_len);
+
+        const unsigned *board = entity_ids + (size_t)i * cells;
+        for (size_t cell = 0; cell < cells; cell++) {
+            if (board[cell] > UINT16_MAX) {
+                fprintf(stderr, "Entity ID %u in board %u does not fit the pack\n", board[cell], i);
+                free(data);
+                return false;
+            }
+            write_u16le(data + record_offset + cell * sizeof(uint16_t), (uint16_t)board[cell]);
+        }
+    }
+
+    FILE *file = fopen(pack_file, "wb");
+    if (!file) {
+        fprintf(stderr, "Failed to create solution pack: %s\n", pack_file);
+        free(data);
+        return false;
+    }
+
+    bool ok = fwrite(data, 1, total_size, file) == total_size;
+    ok = (fclose(file) == 0) && ok;
+    free(data);
+
+    if (!ok) {
+        fprintf(stderr, "Failed to write solution pack: %s\n", pack_file);
+    }
+    return ok;
+}
@@ -0,0 +1,69 @@
+#ifndef SOLUTION_PACK_H
+#define SOLUTION_PACK_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Binary solution pack produced by tools/pack_solutions.c from the JSON
+// solutions file. Every integer is little-endian. Layout:
+//
+//   header  SOLUTION_PACK_HEADER_SIZE bytes (see solution_pack.c)
+//   index   board_count x uint32 absolute file offset of each board record
+//   uuids   board_count x uuid_size bytes, NUL padded
+//   boards  board_count x (rows * cols) x uint16 entity IDs, row-major
+//
+// All boards share one size, so each record has a fixed length and any board
+// can be read with a single seek.
+#define SOLUTION_PACK_MAGIC "MSPK"
+#define SOLUTION_PACK_VERSION 1u
+#define SOLUTION_PACK_HEADER_SIZE 32u
+#define SOLUTION_PACK_UUID_SIZE 40u
+
+typedef struct {
+    unsigned board_count;
+    unsigned rows;
+    unsigned cols;
+    unsigned uuid_size;
+    uint32_t index_offset;
+    uint32_t uuid_offset;
+    uint32_t boards_offset;
+} SolutionPackHeader;
+
+typedef struct {
+    FILE *file;
+    SolutionPackHeader header;
+    uint32_t *board_offsets;    // Offset index, one entry per board
+    uint8_t *record;            // Scratch buffer holding one raw board record
+} SolutionPack;
+
+// Decodes and sanity-checks the first SOLUTION_PACK_HEADER_SIZE bytes of a pack
+bool solution_pack_parse_header(const uint8_t *raw, SolutionPackHeader *header);
+size_t solution_pack_record_size(const SolutionPackHeader *header);
+
+static inline uint32_t solution_pack_u32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+           ((uint32_t)p[3] << 24);
+}
+
+// Entity ID of one cell in a raw (little-endian) board record
+static inline unsigned solution_pack_cell(const uint8_t *record, size_t cell) {
+    return (unsigned)record[cell * 2] | ((unsigned)record[cell * 2 + 1] << 8);
+}
+
+bool solution_pack_open(SolutionPack *pack, const char *pack_file);
+void solution_pack_close(SolutionPack *pack);
+bool solution_pack_read_board(SolutionPack *pack, unsigned index, unsigned *entity_ids);
+bool solution_pack_read_uuid(SolutionPack *pack, unsigned index, char *uuid, size_t uuid_size);
+// Reads the whole UUID table (board_count x uuid_size bytes) in one go and
+// checks that every entry is NUL terminated.
+bool solution_pack_read_uuid_table(SolutionPack *pack, char *uuids);
+
+// Writes a pack from board_count boards of rows x cols entity IDs stored
+// back to back in entity_ids.
+bool solution_pack_write(const char *pack_file, unsigned board_count,
+                         unsigned rows, unsigned cols,
+                         const char *const *uuids, const unsigned *entity_ids);
+
+#endif
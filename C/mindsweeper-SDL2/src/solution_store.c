@@ -0,0 +1,97 @@
+#if !defined(WASM_BUILD) && !defined(_WIN32)
+#define _POSIX_C_SOURCE 200809L
+
+#include "solution_store.h"
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static bool solution_store_validate(const SolutionStore *store) {
+    const SolutionPackHeader *h = &store->header;
+    size_t record_size = solution_pack_record_size(h);
+
+    if ((size_t)h->index_offset + (size_t)h->board_count * sizeof(uint32_t) > store->size ||
+        (size_t)h->uuid_offset + (size_t)h->board_count * h->uuid_size > store->size) {
+        return false;
+    }
+
+    // Check every record once here so solution_store_get can stay O(1)
+    for (unsigned i = 0; i < h->board_count; i++) {
+        size_t offset = solution_pack_u32(store->data + h->index_offset + (size_t)i * sizeof(uint32_t));
+        if (offset + record_size > store->size) {
+            return false;
+        }
+
+        const uint8_t *uuid = store->data + h->uuid_offset + (size_t)i * h->uuid_size;
+        if (uuid[h->uuid_size - 1] != '\0') {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool solution_store_open(SolutionStore *store, const char *pack_file) {
+    memset(store, 0, sizeof(*store));
+
+    int fd = open(pack_file, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "Failed to open solution pack: %s\n", pack_file);
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)SOLUTION_PACK_HEADER_SIZE) {
+        fprintf(stderr, "Truncated solution pack: %s\n", pack_file);
+        close(fd);
+        return false;
+    }
+
+    store->size = (size_t)st.st_size;
+    void *data = mmap(NULL, store->size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        fprintf(stderr, "Failed to mmap solution pack: %s\n", pack_file);
+        store->size = 0;
+        return false;
+    }
+    store->data = data;
+
+    if (!solution_pack_parse_header(store->data, &store->header) ||
+        !solution_store_validate(store)) {
+        fprintf(stderr, "Invalid solution pack: %s\n", pack_file);
+        solution_store_close(store);
+        return false;
+    }
+
+    return true;
+}
+
+void solution_store_close(SolutionStore *store) {
+    if (store->data) {
+        munmap((void *)(uintptr_t)store->data, store->size);
+        store->data = NULL;
+    }
+    store->size = 0;
+    memset(&store->header, 0, sizeof(store->header));
+}
+
+bool solution_store_get(const SolutionStore *store, unsigned index, SolutionView *view) {
+    const SolutionPackHeader *h = &store->header;
+    if (index >= h->board_count) {
+        fprintf(stderr, "Solution index %u out of range (0-%u)\n", index, h->board_count - 1);
+        return false;
+    }
+
+    size_t offset = solution_pack_u32(store->data + h->index_offset + (size_t)index * sizeof(uint32_t));
+    view->cells = store->data + offset;
+    view->uuid = (const char *)(store->data + h->uuid_offset + (size_t)index * h->uuid_size);
+    view->rows = h->rows;
+    view->cols = h->cols;
+
+    return true;
+}
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef SOLUTION_STORE_H
+#define SOLUTION_STORE_H
+
+#include "solution_pack.h"
+
+// POSIX-only, read-only view of a solution pack mapped into memory once.
+// Boards are handed out as pointers into the mapping, so loading a board
+// allocates nothing and processes sharing the pack share its pages.
+#if !defined(WASM_BUILD) && !defined(_WIN32)
+
+typedef struct {
+    const uint8_t *data;        // Whole pack, mapped PROT_READ
+    size_t size;
+    SolutionPackHeader header;
+} SolutionStore;
+
+typedef struct {
+    const uint8_t *cells;       // rows * cols entity IDs, see solution_pack_cell()
+    const char *uuid;           // NUL terminated, points into the mapping
+    unsigned rows;
+    unsigned cols;
+} SolutionView;
+
+bool solution_store_open(SolutionStore *store, const char *pack_file);
+void solution_store_close(SolutionStore *store);
+bool solution_store_get(const SolutionStore *store, unsigned index, SolutionView *view);
+
+#endif
+
+#endif
@@ -0,0 +1,122 @@
+#include "text_cache.h"
+#include <string.h>
+
+// FNV-1a over the text, folded with the font pointer and colour
+static Uint32 text_cache_hash(const TTF_Font *font, const char *text, SDL_Color color) {
+    Uint32 hash = 2166136261u;
+    for (const unsigned char *p = (const unsigned char *)text; *p; p++) {
+        hash = (hash ^ *p) * 16777619u;
+    }
+    hash = (hash ^ (Uint32)(((Uint32)color.r << 24) | ((Uint32)color.g << 16) |
+                            ((Uint32)color.b << 8) | color.a)) * 16777619u;
+    hash = (hash ^ (Uint32)((uintptr_t)font >> 4)) * 16777619u;
+    return hash;
+}
+
+static void text_cache_clear_entry(TextCacheEntry *e) {
+    if (e->texture) {
+        SDL_DestroyTexture(e->texture);
+    }
+    free(e->text);
+    memset(e, 0, sizeof(*e));
+}
+
+static TextCacheEntry* text_cache_find(TextCache *cache, const TTF_Font *font,
+                                       const char *text, SDL_Color color, Uint32 hash) {
+    for (unsigned i = 0; i < TEXT_CACHE_CAPACITY; i++) {
+        TextCacheEntry *e = &cache->entries[i];
+        if (e->text && e->hash == hash && e->font == font &&
+            e->color.r == color.r && e->color.g == color.g &&
+            e->color.b == color.b && e->color.a == color.a &&
+            strcmp(e->text, text) == 0) {
+            return e;
+        }
+    }
+    return NULL;
+}
+
+bool text_cache_new(TextCache **cache, SDL_Renderer *renderer) {
+    *cache = calloc(1, sizeof(TextCache));
+    if (!*cache) {
+        fprintf(stderr, "Error in calloc of text cache.\n");
+        return false;
+    }
+    (*cache)->renderer = renderer;
+    return true;
+}
+
+void text_cache_free(TextCache **cache) {
+    if (*cache) {
+        for (unsigned i = 0; i < TEXT_CACHE_CAPACITY; i++) {
+            text_cache_clear_entry(&(*cache)->entries[i]);
+        }
+        free(*cache);
+        *cache = NULL;
+    }
+}
+
+const TextCacheEntry* text_cache_get(TextCache *cache, TTF_Font *font, const char *text, SDL_Color color) {
+    if (!font || !text || !text[0]) {
+        return NULL;
+    }
+
+    Uint32 hash = text_cache_hash(font, text, color);
+    cache->clock++;
+
+    TextCacheEntry *e = text_cache_find(cache, font, text, color, hash);
+    if (e) {
+        e->last_used = cache->clock;
+        return e;
+    }
+
+    // Miss: reuse an empty slot, otherwise the least recently used one
+    e = &cache->entries[0];
+    for (unsigned i = 0; i < TEXT_CACHE_CAPACITY && e->text; i++) {
+        TextCacheEntry *candidate = &cache->entries[i];
+        if (!candidate->text || candidate->last_used < e->last_used) {
+            e = candidate;
+        }
+    }
+    text_cache_clear_entry(e);
+
+    SDL_Surface *surface = TTF_RenderText_Solid(font, text, color);
+    if (!surface) {
+        return NULL;
+    }
+    e->texture = SDL_CreateTextureFromSurface(cache->renderer, surface);
+    e->w = surface->w;
+    e->h = surface->h;
+    SDL_FreeSurface(surface);
+
+    size_t length = strlen(text);
+    e->text = malloc(length + 1);
+    if (!e->texture || !e->text) {
+        text_cache_clear_entry(e);
+        return NULL;
+    }
+    memcpy(e->text, text, length + 1);
+    e->font = font;
+    e->color = color;
+    e->hash = hash;
+    e->last_used = cache->clock;
+    return e;
+}
+
+bool text_cache_draw(TextCache *cache, TTF_Font *font, const char *text, SDL_Color color, int x, int y) {
+    const TextCacheEntry *e = text_cache_get(cache, font, text, color);
+    if (!e) {
+        return false;
+    }
+
+    SDL_Rect dest_rect = {x, y, e->w, e->h};
+    SDL_RenderCopy(cache->renderer, e->texture, NULL, &dest_rect);
+    return true;
+}
+
+void text_cache_invalidate_font(TextCache *cache, const TTF_Font *font) {
+    for (unsigned i = 0; i < TEXT_CACHE_CAPACITY; i++) {
+        if (cache->entries[i].text && cache->entries[i].font == font) {
+            text_cache_clear_entry(&cache->entries[i]);
+        }
+    }
+}
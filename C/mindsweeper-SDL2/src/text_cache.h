@@ -0,0 +1,40 @@
+#ifndef TEXT_CACHE_H
+#define TEXT_CACHE_H
+
+#include "main.h"
+
+// Rendered text textures keyed by (text, font, colour). A hit costs a hash
+// compare over the slots and no TTF or texture work; a miss renders once and
+// replaces the least recently used slot when the cache is full.
+#define TEXT_CACHE_CAPACITY 128
+
+typedef struct {
+    char *text;                 // NULL when the slot is empty
+    const TTF_Font *font;
+    SDL_Color color;
+    Uint32 hash;
+    SDL_Texture *texture;
+    int w;
+    int h;
+    Uint64 last_used;
+} TextCacheEntry;
+
+typedef struct {
+    SDL_Renderer *renderer;
+    TextCacheEntry entries[TEXT_CACHE_CAPACITY];
+    Uint64 clock;               // Bumped on every lookup, orders slots for LRU
+} TextCache;
+
+bool text_cache_new(TextCache **cache, SDL_Renderer *renderer);
+void text_cache_free(TextCache **cache);
+
+// Returns the cached texture for text, rendering it on a miss. NULL on error.
+const TextCacheEntry* text_cache_get(TextCache *cache, TTF_Font *font, const char *text, SDL_Color color);
+
+// Draws text with its top-left corner at (x, y)
+bool text_cache_draw(TextCache *cache, TTF_Font *font, const char *text, SDL_Color color, int x, int y);
+
+// Drops every entry rendered with font. Call before closing or replacing a font.
+void text_cache_invalidate_font(TextCache *cache, const TTF_Font *font);
+
+#endif
@@ -0,0 +1,114 @@
+#include "tile_atlas.h"
+#include <string.h>
+
+// Blends src over dst (straight alpha, RGBA32 byte order)
+static void tile_atlas_blend(Uint8 *dst, const Uint8 *src) {
+    unsigned src_a = src[3];
+    if (src_a == 0) {
+        return;
+    }
+    unsigned dst_a = dst[3] * (255 - src_a) / 255;
+    unsigned out_a = src_a + dst_a;
+    for (int c = 0; c < 3; c++) {
+        dst[c] = (Uint8)((src[c] * src_a + dst[c] * dst_a) / out_a);
+    }
+    dst[3] = (Uint8)out_a;
+}
+
+// Writes the base tile at (base_x, base_y) of sheet into cell (cell_x, 0) of
+// atlas, then blends the variation at (var_x, var_y) over it rotated
+// clockwise by rotation quarter turns, matching SDL_RenderCopyEx's angle.
+static void tile_atlas_compose(SDL_Surface *atlas, int cell_x, const SDL_Surface *sheet,
+                               int base_x, int base_y, int var_x, int var_y,
+                               unsigned rotation, int size) {
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            // Source pixel that lands on (x, y) after the rotation
+            int sx, sy;
+            switch (rotation) {
+                case 1:  sx = y;            sy = size - 1 - x; break;
+                case 2:  sx = size - 1 - x; sy = size - 1 - y; break;
+                case 3:  sx = size - 1 - y; sy = x;            break;
+                default: sx = x;            sy = y;            break;
+            }
+
+            Uint8 *dst = (Uint8 *)atlas->pixels + y * atlas->pitch + (cell_x + x) * 4;
+            const Uint8 *base = (const Uint8 *)sheet->pixels + (base_y + y) * sheet->pitch + (base_x + x) * 4;
+            const Uint8 *variation = (const Uint8 *)sheet->pixels + (var_y + sy) * sheet->pitch + (var_x + sx) * 4;
+            memcpy(dst, base, 4);
+            tile_atlas_blend(dst, variation);
+        }
+    }
+}
+
+bool tile_atlas_build(TileAtlas *atlas, SDL_Renderer *renderer, const char *path, int piece_size) {
+    memset(atlas, 0, sizeof(*atlas));
+
+    SDL_Surface *loaded = NULL;
+    SDL_Surface *sheet = NULL;
+    SDL_Surface *baked = NULL;
+    bool success = false;
+
+    loaded = IMG_Load(path);
+    if (!loaded) {
+        fprintf(stderr, "Error loading tile sheet %s: %s\n", path, IMG_GetError());
+        goto cleanup;
+    }
+
+    // Pixels are read directly, so work on a known 4-byte format
+    sheet = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA32, 0);
+    if (!sheet) {
+        fprintf(stderr, "Error converting tile sheet: %s\n", SDL_GetError());
+        goto cleanup;
+    }
+
+    int sheet_columns = sheet->w / piece_size;
+    int sheet_tiles = sheet_columns * (sheet->h / piece_size);
+    if (sheet_tiles <= MAX_TILE_VARIATION) {
+        fprintf(stderr, "Tile sheet %s has %d tiles, variation %d needs %d\n",
+                path, sheet_tiles, MAX_TILE_VARIATION, MAX_TILE_VARIATION + 1);
+        goto cleanup;
+    }
+
+    baked = SDL_CreateRGBSurfaceWithFormat(0, piece_size * TILE_ATLAS_HIDDEN_COUNT, piece_size,
+                                           32, SDL_PIXELFORMAT_RGBA32);
+    if (!baked) {
+        fprintf(stderr, "Error creating tile atlas surface: %s\n", SDL_GetError());
+        goto cleanup;
+    }
+
+    for (unsigned v = MIN_TILE_VARIATION; v <= MAX_TILE_VARIATION; v++) {
+        int var_x = (int)v % sheet_columns * piece_size;
+        int var_y = (int)v / sheet_columns * piece_size;
+        for (unsigned r = 0; r < NUM_TILE_ROTATIONS; r++) {
+            unsigned index = tile_atlas_hidden_index(v, r);
+            int cell_x = (int)index * piece_size;
+            tile_atlas_compose(baked, cell_x, sheet, 0, 0, var_x, var_y, r, piece_size);
+            atlas->hidden[index] = (SDL_Rect){cell_x, 0, piece_size, piece_size};
+        }
+    }
+
+    atlas->texture = SDL_CreateTextureFromSurface(renderer, baked);
+    if (!atlas->texture) {
+        fprintf(stderr, "Error creating tile atlas texture: %s\n", SDL_GetError());
+        goto cleanup;
+    }
+    success = true;
+
+cleanup:
+    if (baked) SDL_FreeSurface(baked);
+    if (sheet) SDL_FreeSurface(sheet);
+    if (loaded) SDL_FreeSurface(loaded);
+    return success;
+}
+
+void tile_atlas_free(TileAtlas *atlas) {
+    if (atlas->texture) {
+        SDL_DestroyTexture(atlas->texture);
+        atlas->texture = NULL;
+    }
+}
+
+unsigned tile_atlas_hidden_index(unsigned variation, unsigned rotation) {
+    return (variation - MIN_TILE_VARIATION) * NUM_TILE_ROTATIONS + rotation;
+}
@@ -0,0 +1,26 @@
+#ifndef TILE_ATLAS_H
+#define TILE_ATLAS_H
+
+#include "main.h"
+
+// Every look of a hidden tile baked into one texture: the base tile (sheet
+// index 0) with one variation sprite (MIN..MAX_TILE_VARIATION) composited on
+// top at each quarter-turn rotation. A hidden tile is then one axis-aligned
+// blit instead of a copy plus a rotated SDL_RenderCopyEx.
+#define TILE_ATLAS_VARIATIONS (MAX_TILE_VARIATION - MIN_TILE_VARIATION + 1)
+#define TILE_ATLAS_HIDDEN_COUNT (TILE_ATLAS_VARIATIONS * NUM_TILE_ROTATIONS)
+
+typedef struct {
+    SDL_Texture *texture;
+    SDL_Rect hidden[TILE_ATLAS_HIDDEN_COUNT];   // Source rects, piece_size square
+} TileAtlas;
+
+// Loads the tile sheet at path, cut into piece_size squares, and bakes the
+// hidden tile looks from it
+bool tile_atlas_build(TileAtlas *atlas, SDL_Renderer *renderer, const char *path, int piece_size);
+void tile_atlas_free(TileAtlas *atlas);
+
+// Atlas index of variation rotated clockwise by rotation quarter turns
+unsigned tile_atlas_hidden_index(unsigned variation, unsigned rotation);
+
+#endif
@@ -0,0 +1,140 @@
+// Times the solution loading done by game_new. "json x2" is the old startup,
+// which parsed the JSON solutions file once to load board 0 and again to count
+// the solutions. "catalog" is the current startup: open the pack once, then
+// read the count, UUID 0 and board 0 from it.
+// Usage: bench_startup <solutions.json> <solutions.pack> [iterations]
+#define _POSIX_C_SOURCE 200809L
+
+#include "../src/solution_catalog.h"
+#include <cjson/cJSON.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static double now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e6 + (double)ts.tv_nsec / 1e3;
+}
+
+static char* read_file_contents(const char *filename) {
+    FILE *file = fopen(filename, "rb");
+    if (!file) {
+        fprintf(stderr, "Failed to open file: %s\n", filename);
+        return NULL;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    char *content = malloc((size_t)length + 1);
+    if (!content) {
+        fclose(file);
+        return NULL;
+    }
+
+    size_t read = fread(content, 1, (size_t)length, file);
+    content[read] = '\0';
+    fclose(file);
+
+    return content;
+}
+
+// One full read and parse of the JSON solutions file, as each of the two old
+// startup calls did. Returns the number of solutions to keep the work live.
+static unsigned json_parse_once(const char *json_file) {
+    char *content = read_file_contents(json_file);
+    if (!content) {
+        return 0;
+    }
+
+    cJSON *json = cJSON_Parse(content);
+    free(content);
+    unsigned count = (unsigned)cJSON_GetArraySize(json);
+    cJSON_Delete(json);
+    return count;
+}
+
+static unsigned catalog_startup(const char *pack_file, unsigned *entity_ids) {
+    SolutionCatalog catalog;
+    if (!solution_catalog_open(&catalog, pack_file)) {
+        return 0;
+    }
+
+    unsigned count = solution_catalog_count(&catalog);
+    const char *uuid = solution_catalog_uuid(&catalog, 0);
+    if (!uuid || !solution_catalog_board(&catalog, 0, catalog.header->rows,
+                                         catalog.header->cols, entity_ids)) {
+        count = 0;
+    }
+
+    solution_catalog_close(&catalog);
+    return count;
+}
+
+// Allocates a buffer for one board of the pack, sized from its header
+static unsigned* alloc_board(const char *pack_file) {
+    SolutionCatalog catalog;
+    if (!solution_catalog_open(&catalog, pack_file)) {
+        return NULL;
+    }
+    size_t cells = (size_t)catalog.header->rows * catalog.header->cols;
+    solution_catalog_close(&catalog);
+
+    if (cells == 0) {
+        fprintf(stderr, "Pack has empty boards: %s\n", pack_file);
+        return NULL;
+    }
+    unsigned *entity_ids = malloc(cells * sizeof(unsigned));
+    if (!entity_ids) {
+        fprintf(stderr, "Error in malloc of entity ID buffer.\n");
+    }
+    return entity_ids;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 3 || argc > 4) {
+        fprintf(stderr, "Usage: %s <solutions.json> <solutions.pack> [iterations]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    unsigned iterations = argc == 4 ? (unsigned)strtoul(argv[3], NULL, 10) : 50;
+    if (iterations == 0) {
+        fprintf(stderr, "Iterations must be positive\n");
+        return EXIT_FAILURE;
+    }
+
+    // Board 0 is copied into this buffer exactly as board_load_solution does
+    unsigned *entity_ids = alloc_board(argv[2]);
+    if (!entity_ids) {
+        return EXIT_FAILURE;
+    }
+
+    // Warm the page cache so both paths start from the same state
+    unsigned json_count = json_parse_once(argv[1]);
+    unsigned pack_count = catalog_startup(argv[2], entity_ids);
+    if (json_count == 0 || json_count != pack_count) {
+        fprintf(stderr, "JSON has %u solutions, pack has %u\n", json_count, pack_count);
+        free(entity_ids);
+        return EXIT_FAILURE;
+    }
+
+    double start = now_us();
+    for (unsigned i = 0; i < iterations; i++) {
+        json_count = json_parse_once(argv[1]) + json_parse_once(argv[1]);
+    }
+    double json_us = (now_us() - start) / iterations;
+
+    start = now_us();
+    for (unsigned i = 0; i < iterations; i++) {
+        pack_count = catalog_startup(argv[2], entity_ids);
+    }
+    double catalog_us = (now_us() - start) / iterations;
+
+    printf("%u solutions, %u iterations\n", pack_count, iterations);
+    printf("json x2  %10.1f us/startup\n", json_us);
+    printf("catalog  %10.1f us/startup (%.0fx faster)\n", catalog_us, json_us / catalog_us);
+
+    free(entity_ids);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,656 @@
+// Plays many games on every board of the solution pack with the headless game
+// core and reports how each board plays: win rate, what kills the player and
+// how the player level grows as the board is uncovered.
+// Usage: mindsweeper-sim [-g games] [-p random|greedy|lowest] [-t threads] [-s seed]
+//
+// Boards are tasks on a work-stealing pool. Each worker runs the boards in
+// its own deque from the back and, once that is empty, steals from the front
+// of the others. Every board draws from its own PCG stream of the -s seed,
+// for the policy and for each game's state seed, so a run replays exactly
+// whichever worker plays the board.
+//
+// A game is won when the core reports a trigger-win-game claim (the dragon's
+// crown), lost when the player dies and stalled when nothing is left to
+// click. Results are CSV on stdout, one row per board.
+#include "../src/game_state.h"
+#include "../src/log.h"
+#include <string.h>
+
+#define SIM_DEFAULT_GAMES 1000
+#define SIM_LEVEL_POINTS 11         // Level sampled at 0%, 10%, ... 100% of tiles revealed
+#define SIM_UNSAFE_PENALTY 1e6      // Added to the estimate of a tile known to be fatal
+
+typedef enum {
+    SIM_POLICY_RANDOM = 0,          // Reveal any hidden tile
+    SIM_POLICY_GREEDY,              // Reveal the tile with the lowest expected damage
+    SIM_POLICY_LOWEST               // Safe tiles, then the weakest known enemy, then greedy
+} SimPolicy;
+
+static const char *const sim_policy_names[] = {"random", "greedy", "lowest"};
+
+typedef struct {
+    unsigned games;
+    unsigned wins;
+    unsigned stalls;
+    unsigned long long clicks;
+    unsigned long long final_levels;
+    unsigned *deaths;               // Indexed by entity ID
+    unsigned long long level_sum[SIM_LEVEL_POINTS];
+    unsigned level_games[SIM_LEVEL_POINTS];
+} BoardStats;
+
+typedef struct {
+    SDL_mutex *lock;
+    unsigned *tasks;                // Board indices
+    unsigned head;                  // Thieves take from here
+    unsigned tail;                  // The owner takes from here
+} TaskDeque;
+
+// What a revealed empty tile tells about its hidden neighbours
+typedef struct {
+    unsigned cells[8];              // Hidden neighbour indices
+    unsigned count;
+    unsigned threat;                // Their threat sum
+} SimConstraint;
+
+typedef struct Sim Sim;
+
+typedef struct {
+    Sim *sim;
+    unsigned id;
+    SDL_Thread *thread;
+    GameState state;
+    double *estimates;              // Per tile, expected damage of revealing it
+    unsigned *exact;                // Per tile, known damage or UINT32_MAX
+    SimConstraint *constraints;     // Per tile, valid where has_constraint is set
+    bool *has_constraint;
+} SimWorker;
+
+struct Sim {
+    const GameConfig *config;
+    unsigned rows;
+    unsigned columns;
+    unsigned board_count;
+    unsigned *boards;               // board_count x rows x columns entity IDs
+    BoardStats *stats;
+    bool *heals;                    // Indexed by entity ID: item has a heal effect
+    TaskDeque *deques;
+    SimWorker *workers;
+    unsigned worker_count;
+    unsigned games;
+    SimPolicy policy;
+    uint64_t seed;
+};
+
+// ========== TASK POOL ==========
+
+static bool sim_pop(TaskDeque *d, unsigned *board) {
+    bool found = false;
+    SDL_LockMutex(d->lock);
+    if (d->tail > d->head) {
+        *board = d->tasks[--d->tail];
+        found = true;
+    }
+    SDL_UnlockMutex(d->lock);
+    return found;
+}
+
+static bool sim_steal(TaskDeque *d, unsigned *board) {
+    bool found = false;
+    SDL_LockMutex(d->lock);
+    if (d->tail > d->head) {
+        *board = d->tasks[d->head++];
+        found = true;
+    }
+    SDL_UnlockMutex(d->lock);
+    return found;
+}
+
+// Own work first, then every other deque once, starting at the next worker
+static bool sim_next_task(Sim *sim, unsigned worker, unsigned *board) {
+    if (sim_pop(&sim->deques[worker], board)) {
+        return true;
+    }
+    for (unsigned i = 1; i < sim->worker_count; i++) {
+        if (sim_steal(&sim->deques[(worker + i) % sim->worker_count], board)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// ========== POLICIES ==========
+
+// Where the hidden neighbours of one number are a subset of another's, the
+// difference holds the difference in threat. That pins down tiles the single
+// numbers leave open.
+static void sim_deduce_subsets(SimWorker *w, size_t a) {
+    const GameState *s = &w->state;
+    const SimConstraint *ca = &w->constraints[a];
+    unsigned row = (unsigned)(a / s->columns);
+    unsigned col = (unsigned)(a % s->columns);
+    unsigned row_end = row + 2 < s->rows ? row + 2 : s->rows - 1;
+    unsigned col_end = col + 2 < s->columns ? col + 2 : s->columns - 1;
+
+    for (unsigned r = row > 1 ? row - 2 : 0; r <= row_end; r++) {
+        for (unsigned c = col > 1 ? col - 2 : 0; c <= col_end; c++) {
+            size_t b = (size_t)r * s->columns + c;
+            if (b == a || !w->has_constraint[b]) continue;
+            const SimConstraint *cb = &w->constraints[b];
+            if (cb->count <= ca->count || cb->threat < ca->threat) continue;
+
+            unsigned diff[8];
+            unsigned diff_count = 0;
+            unsigned shared = 0;
+            for (unsigned i = 0; i < cb->count; i++) {
+                bool in_a = false;
+                for (unsigned k = 0; k < ca->count; k++) {
+                    in_a |= ca->cells[k] == cb->cells[i];
+                }
+                if (in_a) {
+                    shared++;
+                } else {
+                    diff[diff_count++] = cb->cells[i];
+                }
+            }
+            if (shared != ca->count) continue;
+
+            unsigned threat = cb->threat - ca->threat;
+            if (threat == 0 || diff_count == 1) {
+                for (unsigned i = 0; i < diff_count; i++) {
+                    w->exact[diff[i]] = threat;
+                }
+            }
+        }
+    }
+}
+
+// Fills w->estimates and w->exact for every hidden tile from what the player
+// can see: the threat shown on revealed empty tiles less the threat of the
+// revealed entities around them. Tiles next to no revealed number get the
+// average threat still hidden on the board.
+static void sim_estimate(SimWorker *w) {
+    const Sim *sim = w->sim;
+    const GameState *s = &w->state;
+    size_t tiles = (size_t)s->rows * s->columns;
+
+    unsigned hidden_count = 0;
+    unsigned long hidden_threat = 0;
+    for (size_t i = 0; i < tiles; i++) {
+        w->estimates[i] = -1.0;
+        w->exact[i] = UINT32_MAX;
+        w->has_constraint[i] = false;
+        if (s->tile_states[i] == TILE_HIDDEN) {
+            hidden_count++;
+            hidden_threat += config_entity_threat(sim->config, s->entity_ids[i]);
+        }
+    }
+
+    for (unsigned row = 0; row < s->rows; row++) {
+        for (unsigned col = 0; col < s->columns; col++) {
+            size_t index = (size_t)row * s->columns + col;
+            if (s->tile_states[index] == TILE_HIDDEN || s->entity_ids[index] != 0) {
+                continue;
+            }
+
+            SimConstraint *con = &w->constraints[index];
+            con->count = 0;
+            con->threat = s->threat_levels[index];
+
+            unsigned row_end = row + 1 < s->rows ? row + 1 : row;
+            unsigned col_end = col + 1 < s->columns ? col + 1 : col;
+            for (unsigned r = row > 0 ? row - 1 : 0; r <= row_end; r++) {
+                for (unsigned c = col > 0 ? col - 1 : 0; c <= col_end; c++) {
+                    size_t n = (size_t)r * s->columns + c;
+                    if (n == index) continue;
+                    if (s->tile_states[n] == TILE_HIDDEN) {
+                        con->cells[con->count++] = (unsigned)n;
+                    } else {
+                        con->threat -= config_entity_threat(sim->config, s->entity_ids[n]);
+                    }
+                }
+            }
+            if (con->count == 0) {
+                continue;
+            }
+            w->has_constraint[index] = true;
+
+            double share = (double)con->threat / con->count;
+            for (unsigned i = 0; i < con->count; i++) {
+                unsigned n = con->cells[i];
+                if (w->estimates[n] < 0.0 || share < w->estimates[n]) {
+                    w->estimates[n] = share;
+                }
+                if (con->count == 1 || con->threat == 0) {
+                    w->exact[n] = con->threat;
+                }
+            }
+        }
+    }
+
+    for (size_t i = 0; i < tiles; i++) {
+        if (w->has_constraint[i]) {
+            sim_deduce_subsets(w, i);
+        }
+    }
+
+    double prior = hidden_count ? (double)hidden_threat / hidden_count : 0.0;
+    for (size_t i = 0; i < tiles; i++) {
+        if (s->tile_states[i] != TILE_HIDDEN) continue;
+        if (w->exact[i] != UINT32_MAX) {
+            w->estimates[i] = w->exact[i];
+        } else if (w->estimates[i] < 0.0) {
+            w->estimates[i] = prior;
+        }
+        if (w->exact[i] != UINT32_MAX && w->exact[i] >= s->player.health) {
+            w->estimates[i] += SIM_UNSAFE_PENALTY;
+        }
+    }
+}
+
+// Returns the tile to click next, or SIZE_MAX when there is none. Revealed
+// items are claimed first; heals wait until the player is hurt.
+static size_t sim_choose(SimWorker *w, Rng *rng) {
+    const Sim *sim = w->sim;
+    const GameState *s = &w->state;
+    size_t tiles = (size_t)s->rows * s->columns;
+
+    unsigned hidden = 0;
+    for (size_t i = 0; i < tiles; i++) {
+        if (s->tile_states[i] == TILE_HIDDEN) {
+            hidden++;
+            continue;
+        }
+        const Entity *entity = config_get_entity(sim->config, s->entity_ids[i]);
+        if (entity && (entity->is_item || entity->is_trigger) && s->transitions[i] == GAME_TRANSITION_NONE &&
+            (!sim->heals[entity->id] || s->player.health < s->player.max_health)) {
+            return i;
+        }
+    }
+    if (hidden == 0) {
+        return SIZE_MAX;
+    }
+
+    if (sim->policy == SIM_POLICY_RANDOM) {
+        unsigned pick = rng_below(rng, hidden);
+        for (size_t i = 0; i < tiles; i++) {
+            if (s->tile_states[i] == TILE_HIDDEN && pick-- == 0) {
+                return i;
+            }
+        }
+    }
+
+    sim_estimate(w);
+
+    if (sim->policy == SIM_POLICY_LOWEST) {
+        // A known-safe tile, else the weakest enemy the player is sure to survive
+        size_t weakest = SIZE_MAX;
+        for (size_t i = 0; i < tiles; i++) {
+            if (s->tile_states[i] != TILE_HIDDEN || w->exact[i] >= s->player.health) continue;
+            if (w->exact[i] == 0) {
+                return i;
+            }
+            if (weakest == SIZE_MAX || w->exact[i] < w->exact[weakest]) {
+                weakest = i;
+            }
+        }
+        if (weakest != SIZE_MAX) {
+            return weakest;
+        }
+    }
+
+    // Lowest estimate, ties broken at random
+    size_t best = SIZE_MAX;
+    unsigned ties = 0;
+    for (size_t i = 0; i < tiles; i++) {
+        if (s->tile_states[i] != TILE_HIDDEN) continue;
+        if (best == SIZE_MAX || w->estimates[i] < w->estimates[best]) {
+            best = i;
+            ties = 1;
+        } else if (!(w->estimates[i] > w->estimates[best]) && rng_below(rng, ++ties) == 0) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+// ========== GAMES ==========
+
+static void sim_play(SimWorker *w, const unsigned *board, Rng *rng, BoardStats *stats) {
+    GameState *s = &w->state;
+    size_t tiles = (size_t)s->rows * s->columns;
+
+    game_state_set_board(s, board);
+    game_state_seed(s, rng_next64(rng));
+    game_state_reset_game_over(s);
+    game_state_init_player(s);
+
+    // Every click lets the transitions it started finish before the next one
+    uint32_t now = 0;
+    size_t revealed = 0;
+    unsigned point = 0;
+    unsigned clicks = 0;
+
+    for (;;) {
+        while (point < SIM_LEVEL_POINTS && revealed * (SIM_LEVEL_POINTS - 1) >= point * tiles) {
+            stats->level_sum[point] += s->player.level;
+            stats->level_games[point]++;
+            point++;
+        }
+
+        if (game_state_can_level_up(s)) {
+            game_state_level_up(s);
+        }
+
+        size_t index = sim_choose(w, rng);
+        if (index == SIZE_MAX) {
+            stats->stalls++;
+            break;
+        }
+
+        unsigned entity_id = s->entity_ids[index];
+        GameClickResult result = game_state_click(s, (unsigned)(index / s->columns),
+                                                  (unsigned)(index % s->columns), now);
+        clicks++;
+        now += GAME_COMBAT_TRANSITION_MS;
+        game_state_advance(s, now);
+
+        if (result == GAME_CLICK_DIED) {
+            stats->deaths[entity_id]++;
+            break;
+        }
+        if (result == GAME_CLICK_WON) {
+            stats->wins++;
+            break;
+        }
+
+        // Reveal effects can uncover more than the clicked tile
+        revealed = 0;
+        for (size_t i = 0; i < tiles; i++) {
+            revealed += s->tile_states[i] == TILE_REVEALED;
+        }
+    }
+
+    stats->games++;
+    stats->clicks += clicks;
+    stats->final_levels += s->player.level;
+}
+
+static int sim_worker_run(void *data) {
+    SimWorker *w = data;
+    Sim *sim = w->sim;
+    size_t tiles = (size_t)sim->rows * sim->columns;
+
+    unsigned board;
+    while (sim_next_task(sim, w->id, &board)) {
+        Rng rng;
+        rng_seed(&rng, sim->seed, board);
+        for (unsigned game = 0; game < sim->games; game++) {
+            sim_play(w, sim->boards + board * tiles, &rng, &sim->stats[board]);
+        }
+    }
+    return 0;
+}
+
+// ========== REPORT ==========
+
+static void sim_print_header(void) {
+    printf("board,uuid,games,wins,win_rate,stalls,mean_clicks,mean_final_level");
+    for (unsigned p = 0; p < SIM_LEVEL_POINTS; p++) {
+        printf(",level_%u", p * 100 / (SIM_LEVEL_POINTS - 1));
+    }
+    printf(",deaths\n");
+}
+
+static void sim_print_board(const Sim *sim, const SolutionCatalog *solutions, unsigned board) {
+    const BoardStats *st = &sim->stats[board];
+    double games = st->games ? st->games : 1;
+
+    printf("%u,%s,%u,%u,%.4f,%u,%.2f,%.2f", board, solution_catalog_uuid(solutions, board),
+           st->games, st->wins, st->wins / games, st->stalls,
+           (double)st->clicks / games, (double)st->final_levels / games);
+    for (unsigned p = 0; p < SIM_LEVEL_POINTS; p++) {
+        if (st->level_games[p]) {
+            printf(",%.2f", (double)st->level_sum[p] / st->level_games[p]);
+        } else {
+            printf(",");
+        }
+    }
+
+    // Death causes as name=count, separated by semicolons
+    printf(",\"");
+    bool first = true;
+    for (unsigned id = 0; id < sim->config->lookup_size; id++) {
+        const Entity *entity = config_get_entity(sim->config, id);
+        if (st->deaths[id] && entity) {
+            printf("%s%s=%u", first ? "" : ";", entity->name, st->deaths[id]);
+            first = false;
+        }
+    }
+    printf("\"\n");
+}
+
+// ========== SETUP ==========
+
+static bool sim_parse_args(Sim *sim, int argc, char **argv) {
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        if (i + 1 >= argc || arg[0] != '-' || arg[1] == '\0' || arg[2] != '\0') {
+            return false;
+        }
+        const char *value = argv[++i];
+        char *end;
+        switch (arg[1]) {
+            case 'g':
+                sim->games = (unsigned)strtoul(value, &end, 10);
+                if (*end != '\0' || sim->games == 0) return false;
+                break;
+            case 't':
+                sim->worker_count = (unsigned)strtoul(value, &end, 10);
+                if (*end != '\0' || sim->worker_count == 0) return false;
+                break;
+            case 's':
+                sim->seed = strtoull(value, &end, 10);
+                if (*end != '\0') return false;
+                break;
+            case 'p': {
+                bool known = false;
+                for (unsigned p = 0; p < sizeof(sim_policy_names) / sizeof(sim_policy_names[0]); p++) {
+                    if (strcmp(value, sim_policy_names[p]) == 0) {
+                        sim->policy = (SimPolicy)p;
+                        known = true;
+                    }
+                }
+                if (!known) return false;
+                break;
+            }
+            default:
+                return false;
+        }
+    }
+    return true;
+}
+
+// Reads every board once; games replay them from memory
+static bool sim_load_boards(Sim *sim, SolutionCatalog *solutions) {
+    size_t tiles = (size_t)sim->rows * sim->columns;
+    sim->boards = malloc((size_t)sim->board_count * tiles * sizeof(unsigned));
+    if (!sim->boards) {
+        fprintf(stderr, "Error in malloc of simulation boards.\n");
+        return false;
+    }
+    for (unsigned board = 0; board < sim->board_count; board++) {
+        if (!solution_catalog_board(solutions, board, sim->rows, sim->columns, sim->boards + board * tiles)) {
+            fprintf(stderr, "Failed to read board %u\n", board);
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool sim_setup(Sim *sim) {
+    sim->stats = calloc(sim->board_count, sizeof(BoardStats));
+    sim->heals = calloc(sim->config->lookup_size, sizeof(bool));
+    sim->deques = calloc(sim->worker_count, sizeof(TaskDeque));
+    sim->workers = calloc(sim->worker_count, sizeof(SimWorker));
+    if (!sim->stats || !sim->heals || !sim->deques || !sim->workers) {
+        fprintf(stderr, "Error in calloc of simulation state.\n");
+        return false;
+    }
+
+    for (unsigned board = 0; board < sim->board_count; board++) {
+        sim->stats[board].deaths = calloc(sim->config->lookup_size, sizeof(unsigned));
+        if (!sim->stats[board].deaths) {
+            fprintf(stderr, "Error in calloc of death counts.\n");
+            return false;
+        }
+    }
+
+    for (unsigned id = 0; id < sim->config->lookup_size; id++) {
+        const EntityLookup *lookup = config_lookup(sim->config, id);
+        for (unsigned e = 0; e < lookup->effect_count; e++) {
+            if (lookup->effects[e].opcode == EFFECT_HEAL) {
+                sim->heals[id] = true;
+            }
+        }
+    }
+
+    // Deal the boards round-robin; stealing evens out the rest
+    for (unsigned i = 0; i < sim->worker_count; i++) {
+        TaskDeque *d = &sim->deques[i];
+        d->lock = SDL_CreateMutex();
+        d->tasks = malloc(((size_t)sim->board_count / sim->worker_count + 1) * sizeof(unsigned));
+        if (!d->lock || !d->tasks) {
+            fprintf(stderr, "Error creating task deque: %s\n", SDL_GetError());
+            return false;
+        }
+    }
+    for (unsigned board = 0; board < sim->board_count; board++) {
+        TaskDeque *d = &sim->deques[board % sim->worker_count];
+        d->tasks[d->tail++] = board;
+    }
+
+    size_t tiles = (size_t)sim->rows * sim->columns;
+    for (unsigned i = 0; i < sim->worker_count; i++) {
+        SimWorker *w = &sim->workers[i];
+        w->sim = sim;
+        w->id = i;
+        w->estimates = malloc(tiles * sizeof(double));
+        w->exact = malloc(tiles * sizeof(unsigned));
+        w->constraints = malloc(tiles * sizeof(SimConstraint));
+        w->has_constraint = malloc(tiles * sizeof(bool));
+        if (!w->estimates || !w->exact || !w->constraints || !w->has_constraint ||
+            !game_state_init(&w->state, sim->config, sim->rows, sim->columns)) {
+            fprintf(stderr, "Error setting up simulation worker %u\n", i);
+            return false;
+        }
+    }
+    return true;
+}
+
+static void sim_free(Sim *sim) {
+    if (sim->workers) {
+        for (unsigned i = 0; i < sim->worker_count; i++) {
+            game_state_free(&sim->workers[i].state);
+            free(sim->workers[i].estimates);
+            free(sim->workers[i].exact);
+            free(sim->workers[i].constraints);
+            free(sim->workers[i].has_constraint);
+        }
+    }
+    if (sim->deques) {
+        for (unsigned i = 0; i < sim->worker_count; i++) {
+            if (sim->deques[i].lock) {
+                SDL_DestroyMutex(sim->deques[i].lock);
+            }
+            free(sim->deques[i].tasks);
+        }
+    }
+    if (sim->stats) {
+        for (unsigned board = 0; board < sim->board_count; board++) {
+            free(sim->stats[board].deaths);
+        }
+    }
+    free(sim->workers);
+    free(sim->deques);
+    free(sim->heals);
+    free(sim->stats);
+    free(sim->boards);
+}
+
+int main(int argc, char **argv) {
+    GameConfig config = {0};
+    SolutionCatalog solutions = {0};
+    bool solutions_open = false;
+    int exit_status = EXIT_FAILURE;
+
+    Sim sim = {
+        .config = &config,
+        .games = SIM_DEFAULT_GAMES,
+        .policy = SIM_POLICY_GREEDY,
+        .worker_count = (unsigned)SDL_GetCPUCount(),
+        .seed = 1,
+    };
+    if (!sim_parse_args(&sim, argc, argv)) {
+        fprintf(stderr, "Usage: %s [-g games] [-p random|greedy|lowest] [-t threads] [-s seed]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (!config_load(&config, GAME_CONFIG_FILE)) {
+        fprintf(stderr, "Failed to load game config\n");
+        goto cleanup;
+    }
+    if (!solution_catalog_open(&solutions, SOLUTION_PACK_FILE)) {
+        goto cleanup;
+    }
+    solutions_open = true;
+
+    sim.rows = solutions.header->rows;
+    sim.columns = solutions.header->cols;
+    sim.board_count = solution_catalog_count(&solutions);
+    if (sim.worker_count > sim.board_count) {
+        sim.worker_count = sim.board_count;
+    }
+    if (!sim_load_boards(&sim, &solutions) || !sim_setup(&sim)) {
+        goto cleanup;
+    }
+
+    Uint64 start = SDL_GetPerformanceCounter();
+
+    // The main thread is worker 0
+    for (unsigned i = 1; i < sim.worker_count; i++) {
+        sim.workers[i].thread = SDL_CreateThread(sim_worker_run, "sim", &sim.workers[i]);
+        if (!sim.workers[i].thread) {
+            fprintf(stderr, "Error creating worker thread: %s\n", SDL_GetError());
+        }
+    }
+    sim_worker_run(&sim.workers[0]);
+    for (unsigned i = 1; i < sim.worker_count; i++) {
+        if (sim.workers[i].thread) {
+            SDL_WaitThread(sim.workers[i].thread, NULL);
+        }
+    }
+
+    double seconds = (double)(SDL_GetPerformanceCounter() - start) / (double)SDL_GetPerformanceFrequency();
+
+    sim_print_header();
+    unsigned long long total_games = 0, total_wins = 0;
+    for (unsigned board = 0; board < sim.board_count; board++) {
+        sim_print_board(&sim, &solutions, board);
+        total_games += sim.stats[board].games;
+        total_wins += sim.stats[board].wins;
+    }
+    fprintf(stderr, "%s: %llu games on %u boards, %llu wins, %u threads, %.2fs (%.0f games/s)\n",
+            sim_policy_names[sim.policy], total_games, sim.board_count, total_wins,
+            sim.worker_count, seconds, seconds > 0 ? (double)total_games / seconds : 0.0);
+    exit_status = EXIT_SUCCESS;
+
+cleanup:
+    sim_free(&sim);
+    if (solutions_open) {
+        solution_catalog_close(&solutions);
+    }
+    config_free(&config);
+    log_shutdown();
+    return exit_status;
+}
@@ -0,0 +1,266 @@
+// Converts the JSON solutions file into the binary solution pack read by the
+// game. Usage: pack_solutions <solutions.json> <solutions.pack>
+//
+// The JSON is read in one forward pass with the same tokenizer the game uses
+// for its config, writing entity IDs straight into the pack buffers.
+#include "../src/json_reader.h"
+#include "../src/solution_pack.h"
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    unsigned count;
+    unsigned capacity;
+    unsigned rows;
+    unsigned cols;
+    char *uuids;                // capacity x SOLUTION_PACK_UUID_SIZE
+    unsigned *entity_ids;       // capacity x rows x cols, allocated once the size is known
+} Solutions;
+
+static char* read_file_contents(const char *filename, size_t *length) {
+    FILE *file = fopen(filename, "rb");
+    if (!file) {
+        fprintf(stderr, "Failed to open file: %s\n", filename);
+        return NULL;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long file_length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if (file_length < 0) {
+        fclose(file);
+        return NULL;
+    }
+
+    char *content = malloc((size_t)file_length + 1);
+    if (!content) {
+        fclose(file);
+        return NULL;
+    }
+
+    *length = fread(content, 1, (size_t)file_length, file);
+    content[*length] = '\0';
+    fclose(file);
+
+    return content;
+}
+
+static bool solutions_grow(Solutions *s) {
+    unsigned capacity = s->capacity ? s->capacity * 2 : 256;
+
+    char *uuids = realloc(s->uuids, (size_t)capacity * SOLUTION_PACK_UUID_SIZE);
+    if (!uuids) {
+        return false;
+    }
+    s->uuids = uuids;
+
+    if (s->rows > 0) {
+        unsigned *entity_ids = realloc(s->entity_ids, (size_t)capacity * s->rows * s->cols * sizeof(unsigned));
+        if (!entity_ids) {
+            return false;
+        }
+        s->entity_ids = entity_ids;
+    }
+
+    s->capacity = capacity;
+    return true;
+}
+
+// Reads one board row into cells, returning the number of entries in it. The
+// first row of the first board is read into a scratch row since the width is
+// not yet known.
+static bool parse_row(JsonReader *r, unsigned index, unsigned row, unsigned *cells,
+                      unsigned max_cols, unsigned *cols) {
+    JsonToken value;
+    *cols = 0;
+    while (json_reader_element(r, &value)) {
+        unsigned id;
+        if (*cols >= max_cols || !json_token_unsigned(&value, &id)) {
+            fprintf(stderr, "Solution %u has an invalid entity at [%u,%u]\n", index, row, *cols);
+            return false;
+        }
+        cells[(*cols)++] = id;
+    }
+    return !json_reader_failed(r);
+}
+
+static bool parse_board(JsonReader *r, Solutions *s) {
+    unsigned index = s->count;
+    unsigned rows = 0;
+    unsigned scratch[UINT16_MAX];
+
+    JsonToken value;
+    while (json_reader_element(r, &value)) {
+        if (value.type != JSON_TOKEN_ARRAY_BEGIN) {
+            fprintf(stderr, "Solution %u row %u is not an array\n", index, rows);
+            return false;
+        }
+
+        unsigned cols;
+        if (s->rows == 0) {
+            // Sizing board: rows are gathered in scratch until the first
+            // board closes and the pack dimensions are fixed.
+            if (rows > 0 && (size_t)(rows + 1) * s->cols > UINT16_MAX) {
+                fprintf(stderr, "Solution %u is too large\n", index);
+                return false;
+            }
+            unsigned *cells = scratch + (size_t)rows * s->cols;
+            if (!parse_row(r, index, rows, cells, UINT16_MAX - (unsigned)(cells - scratch), &cols)) {
+                return false;
+            }
+            if (rows == 0) {
+                s->cols = cols;
+            }
+        } else {
+            if (rows >= s->rows) {
+                fprintf(stderr, "Solution %u has more than %u rows\n", index, s->rows);
+                return false;
+            }
+            unsigned *cells = s->entity_ids + ((size_t)index * s->rows + rows) * s->cols;
+            if (!parse_row(r, index, rows, cells, s->cols, &cols)) {
+                return false;
+            }
+        }
+
+        if (cols != s->cols || cols == 0) {
+            fprintf(stderr, "Solution %u row %u is ragged\n", index, rows);
+            return false;
+        }
+        rows++;
+    }
+    if (json_reader_failed(r)) {
+        return false;
+    }
+
+    if (s->rows == 0) {
+        if (rows == 0) {
+            fprintf(stderr, "Solution %u has an empty board\n", index);
+            return false;
+        }
+        s->rows = rows;
+        s->entity_ids = malloc((size_t)s->capacity * s->rows * s->cols * sizeof(unsigned));
+        if (!s->entity_ids) {
+            fprintf(stderr, "Error in malloc of entity ID buffer.\n");
+            return false;
+        }
+        memcpy(s->entity_ids, scratch, (size_t)rows * s->cols * sizeof(unsigned));
+    } else if (rows != s->rows) {
+        fprintf(stderr, "Solution %u is %ux%u, expected %ux%u\n",
+                index, rows, s->cols, s->rows, s->cols);
+        return false;
+    }
+    return true;
+}
+
+static bool parse_solution(JsonReader *r, Solutions *s) {
+    unsigned index = s->count;
+    char *uuid = s->uuids + (size_t)index * SOLUTION_PACK_UUID_SIZE;
+    bool has_uuid = false;
+    bool has_board = false;
+
+    JsonToken key, value;
+    while (json_reader_member(r, &key, &value)) {
+        if (json_token_equals(&key, "uuid")) {
+            if (!json_token_copy_string(&value, uuid, SOLUTION_PACK_UUID_SIZE)) {
+                fprintf(stderr, "UUID of board %u is not a string shorter than %u bytes\n",
+                        index, SOLUTION_PACK_UUID_SIZE);
+                return false;
+            }
+            has_uuid = true;
+        } else if (json_token_equals(&key, "board")) {
+            if (value.type != JSON_TOKEN_ARRAY_BEGIN || !parse_board(r, s)) {
+                fprintf(stderr, "Solution %u has an invalid board\n", index);
+                return false;
+            }
+            has_board = true;
+        } else if (!json_reader_skip(r, &value)) {
+            return false;
+        }
+    }
+    if (json_reader_failed(r)) {
+        return false;
+    }
+
+    if (!has_uuid || !has_board) {
+        fprintf(stderr, "Solution %u is missing uuid or board\n", index);
+        return false;
+    }
+    return true;
+}
+
+static bool parse_solutions(JsonReader *r, Solutions *s) {
+    JsonToken value;
+    if (!json_reader_next(r, &value) || value.type != JSON_TOKEN_ARRAY_BEGIN) {
+        fprintf(stderr, "Solution file is not a JSON array\n");
+        return false;
+    }
+
+    while (json_reader_element(r, &value)) {
+        if (value.type != JSON_TOKEN_OBJECT_BEGIN) {
+            fprintf(stderr, "Solution %u is not an object\n", s->count);
+            return false;
+        }
+        if (s->count == s->capacity && !solutions_grow(s)) {
+            fprintf(stderr, "Error in realloc of solution buffers.\n");
+            return false;
+        }
+        if (!parse_solution(r, s)) {
+            return false;
+        }
+        s->count++;
+    }
+
+    return !json_reader_failed(r) && json_reader_next(r, &value) && value.type == JSON_TOKEN_END;
+}
+
+int main(int argc, char **argv) {
+    if (argc != 3) {
+        fprintf(stderr, "Usage: %s <solutions.json> <solutions.pack>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    size_t length = 0;
+    char *content = read_file_contents(argv[1], &length);
+    if (!content) {
+        return EXIT_FAILURE;
+    }
+
+    int exit_status = EXIT_FAILURE;
+    Solutions solutions = {0};
+    const char **uuids = NULL;
+
+    JsonReader reader;
+    json_reader_init(&reader, content, length);
+    if (!parse_solutions(&reader, &solutions)) {
+        if (json_reader_failed(&reader)) {
+            json_reader_print_error(&reader, argv[1]);
+        }
+        goto cleanup;
+    }
+    if (solutions.count == 0) {
+        fprintf(stderr, "No solutions in %s\n", argv[1]);
+        goto cleanup;
+    }
+
+    uuids = calloc(solutions.count, sizeof(char *));
+    if (!uuids) {
+        goto cleanup;
+    }
+    for (unsigned i = 0; i < solutions.count; i++) {
+        uuids[i] = solutions.uuids + (size_t)i * SOLUTION_PACK_UUID_SIZE;
+    }
+
+    if (solution_pack_write(argv[2], solutions.count, solutions.rows, solutions.cols,
+                            uuids, solutions.entity_ids)) {
+        printf("Packed %u solutions (%ux%u) into %s\n", solutions.count,
+               solutions.rows, solutions.cols, argv[2]);
+        exit_status = EXIT_SUCCESS;
+    }
+
+cleanup:
+    free(uuids);
+    free(solutions.entity_ids);
+    free(solutions.uuids);
+    free(content);
+    return exit_status;
+}
@@ -0,0 +1,141 @@
+#include "adjacency.h"
+#include "board.h"
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#endif
+
+unsigned adjacency_row_simd(Uint8 *row, const Uint8 *above, const Uint8 *below,
+                            unsigned columns);
+void adjacency_row_scalar(Uint8 *row, const Uint8 *above, const Uint8 *below,
+                          unsigned first, unsigned last);
+
+// Each count is the sum of the 8 neighbours' mine bits. The ghost border
+// makes every interior cell the same case, so a whole run of cells is summed
+// from the mine plane shifted one cell left and right in the rows above, at
+// and below it. Every mine bit is 0x10, so eight of them still fit in a byte
+// and a shift by 4 turns the sum into the count. There is no 8-bit vector
+// shift; the 16-bit one carries the high byte's low bits into the low byte,
+// and the count mask drops them. Writing a count leaves the mine bit the
+// neighbouring cells read untouched.
+
+// Counts as many whole vectors of the row as fit and returns the first
+// column left for the scalar tail
+unsigned adjacency_row_simd(Uint8 *row, const Uint8 *above, const Uint8 *below,
+                            unsigned columns) {
+    unsigned c = 1;
+
+#if defined(__AVX2__)
+    const __m256i wide_mine = _mm256_set1_epi8((char)CELL_MINE);
+    const __m256i wide_count_mask = _mm256_set1_epi8((char)CELL_COUNT_MASK);
+#define MINES(p)                                                               \
+    _mm256_and_si256(_mm256_loadu_si256((const __m256i *)(p)), wide_mine)
+    for (; c + 32 <= columns + 1; c += 32) {
+        __m256i sum = _mm256_add_epi8(
+            _mm256_add_epi8(
+                _mm256_add_epi8(MINES(above + c - 1), MINES(above + c)),
+                _mm256_add_epi8(MINES(above + c + 1), MINES(row + c - 1))),
+            _mm256_add_epi8(
+                _mm256_add_epi8(MINES(row + c + 1), MINES(below + c - 1)),
+                _mm256_add_epi8(MINES(below + c), MINES(below + c + 1))));
+        __m256i counts =
+            _mm256_and_si256(_mm256_srli_epi16(sum, 4), wide_count_mask);
+        __m256i cell = _mm256_loadu_si256((const __m256i *)(row + c));
+        cell = _mm256_andnot_si256(wide_count_mask, cell);
+        _mm256_storeu_si256((__m256i *)(row + c),
+                            _mm256_or_si256(cell, counts));
+    }
+#undef MINES
+#endif
+
+#if defined(__SSE2__)
+    // Also takes the 16-column run AVX2 leaves before the scalar tail
+    const __m128i mine = _mm_set1_epi8((char)CELL_MINE);
+    const __m128i count_mask = _mm_set1_epi8((char)CELL_COUNT_MASK);
+#define MINES(p) _mm_and_si128(_mm_loadu_si128((const __m128i *)(p)), mine)
+    for (; c + 16 <= columns + 1; c += 16) {
+        __m128i sum = _mm_add_epi8(
+            _mm_add_epi8(
+                _mm_add_epi8(MINES(above + c - 1), MINES(above + c)),
+                _mm_add_epi8(MINES(above + c + 1), MINES(row + c - 1))),
+            _mm_add_epi8(
+                _mm_add_epi8(MINES(row + c + 1), MINES(below + c - 1)),
+                _mm_add_epi8(MINES(below + c), MINES(below + c + 1))));
+        __m128i counts = _mm_and_si128(_mm_srli_epi16(sum, 4), count_mask);
+        __m128i cell = _mm_loadu_si128((const __m128i *)(row + c));
+        cell = _mm_andnot_si128(count_mask, cell);
+        _mm_storeu_si128((__m128i *)(row + c), _mm_or_si128(cell, counts));
+    }
+#undef MINES
+#elif defined(__wasm_simd128__)
+    const v128_t mine = wasm_i8x16_splat((int8_t)CELL_MINE);
+    const v128_t count_mask = wasm_i8x16_splat((int8_t)CELL_COUNT_MASK);
+#define MINES(p) wasm_v128_and(wasm_v128_load(p), mine)
+    for (; c + 16 <= columns + 1; c += 16) {
+        v128_t sum = wasm_i8x16_add(
+            wasm_i8x16_add(
+                wasm_i8x16_add(MINES(above + c - 1), MINES(above + c)),
+                wasm_i8x16_add(MINES(above + c + 1), MINES(row + c - 1))),
+            wasm_i8x16_add(
+                wasm_i8x16_add(MINES(row + c + 1), MINES(below + c - 1)),
+                wasm_i8x16_add(MINES(below + c), MINES(below + c + 1))));
+        v128_t counts = wasm_v128_and(wasm_u16x8_shr(sum, 4), count_mask);
+        v128_t cell = wasm_v128_load(row + c);
+        cell = wasm_v128_andnot(cell, count_mask);
+        wasm_v128_store(row + c, wasm_v128_or(cell, counts));
+    }
+#undef MINES
+#else
+    (void)row;
+    (void)above;
+    (void)below;
+    (void)columns;
+#endif
+
+    return c;
+}
+
+void adjacency_row_scalar(Uint8 *row, const Uint8 *above, const Uint8 *below,
+                          unsigned first, unsigned last) {
+    for (unsigned c = first; c <= last; c++) {
+        unsigned mine_bits =
+            (unsigned)((above[c - 1] & CELL_MINE) + (above[c] & CELL_MINE) +
+                       (above[c + 1] & CELL_MINE) + (row[c - 1] & CELL_MINE) +
+                       (row[c + 1] & CELL_MINE) + (below[c - 1] & CELL_MINE) +
+                       (below[c] & CELL_MINE) + (below[c + 1] & CELL_MINE));
+        row[c] = (Uint8)((row[c] & ~CELL_COUNT_MASK) | (mine_bits >> 4));
+    }
+}
+
+void adjacency_count(Uint8 *cells, unsigned rows, unsigned columns,
+                     unsigned stride) {
+    for (unsigned r = 1; r <= rows; r++) {
+        Uint8 *row = cells + (size_t)r * stride;
+        const Uint8 *above = row - stride;
+        const Uint8 *below = row + stride;
+        unsigned c = adjacency_row_simd(row, above, below, columns);
+        adjacency_row_scalar(row, above, below, c, columns);
+    }
+}
+
+void adjacency_count_scalar(Uint8 *cells, unsigned rows, unsigned columns,
+                            unsigned stride) {
+    for (unsigned r = 1; r <= rows; r++) {
+        Uint8 *row = cells + (size_t)r * stride;
+        adjacency_row_scalar(row, row - stride, row + stride, 1, columns);
+    }
+}
+
+const char *adjacency_kernel_name(void) {
+#if defined(__AVX2__)
+    return "avx2";
+#elif defined(__SSE2__)
+    return "sse2";
+#elif defined(__wasm_simd128__)
+    return "wasm-simd128";
+#else
+    return "scalar";
+#endif
+}
@@ -0,0 +1,17 @@
+#ifndef ADJACENCY_H
+#define ADJACENCY_H
+
+#include "main.h"
+
+// Writes the adjacent mine count of every interior cell of a board stored
+// with a ghost border (see board.h), leaving the mine and state bits alone.
+// Uses AVX2, SSE2 or WASM SIMD when the build targets them.
+void adjacency_count(Uint8 *cells, unsigned rows, unsigned columns,
+                     unsigned stride);
+// The same counts one cell at a time, for comparison
+void adjacency_count_scalar(Uint8 *cells, unsigned rows, unsigned columns,
+                            unsigned stride);
+// Name of the vector kernel adjacency_count was built with
+const char *adjacency_kernel_name(void);
+
+#endif
@@ -1,13 +1,29 @@
 #include "board.h"
+#include "adjacency.h"
+#include "generator.h"
 #include "load_media.h"
 
 bool board_calloc_arrays(struct Board *b);
 void board_free_arrays(struct Board *b);
-bool board_push_check(struct Board *b, int row, int column);
-struct Pos board_pop_check(struct Board *b);
-bool board_uncover(struct Board *b);
-void board_reveal(struct Board *b);
+void board_place_mines(struct Board *b, unsigned first_index);
+void board_start_no_guess(struct Board *b, unsigned first_index);
+bool board_place_no_guess(struct Board *b, unsigned first_index);
+void board_push_check(struct Board *b, unsigned index);
+void board_uncover(struct Board *b);
 void board_check_won(struct Board *b);
+bool board_cell_at(const struct Board *b, int x, int y, unsigned *index);
+unsigned board_cell_sprite(const struct Board *b, unsigned index);
+
+// Sprite in board.png for each CellState; uncovered cells add their count
+static const unsigned board_state_sprites[] = {0, 9, 10, 11, 13, 14, 15};
+
+static inline unsigned cell_state(Uint8 cell) {
+    return (cell & CELL_STATE_MASK) >> CELL_STATE_SHIFT;
+}
+
+static inline void cell_set_state(Uint8 *cell, unsigned state) {
+    *cell = (Uint8)((*cell & ~CELL_STATE_MASK) | (state << CELL_STATE_SHIFT));
+}
 
 bool board_new(struct Board **board, SDL_Renderer *renderer, unsigned rows,
                unsigned columns, int scale, int mine_count) {
@@ -26,6 +42,10 @@ bool board_new(struct Board **board, SDL_Renderer *renderer, unsigned rows,
     b->game_status = 0;
     b->first_turn = true;
 
+    if (!generator_new(&b->generator)) {
+        return false;
+    }
+
     if (!load_media_sheet(b->renderer, &b->image, "images/board.png",
                           PIECE_SIZE, PIECE_SIZE, &b->src_rects)) {
         return false;
@@ -33,7 +53,7 @@ bool board_new(struct Board **board, SDL_Renderer *renderer, unsigned rows,
 
     board_set_scale(b, b->scale);
 
-    if (!board_reset(b, b->mine_count, true)) {
+    if (!board_reset(b, b->mine_count)) {
         return false;
     }
 
@@ -44,6 +64,7 @@ void board_free(struct Board **board) {
     if (*board) {
         struct Board *b = *board;
 
+        generator_free(&b->generator);
         board_free_arrays(b);
 
         if (b->src_rects) {
@@ -68,242 +89,233 @@ void board_free(struct Board **board) {
 }
 
 bool board_calloc_arrays(struct Board *b) {
-    b->front_array = calloc(b->rows, sizeof(unsigned *));
-    if (!b->front_array) {
-        fprintf(stderr, "Error in calloc of front array rows!\n");
-        return false;
-    }
+    b->stride = b->columns + 2;
 
-    for (unsigned r = 0; r < b->rows; r++) {
-        b->front_array[r] = calloc(b->columns, sizeof(unsigned));
-        if (!b->front_array[r]) {
-            fprintf(stderr, "Error in calloc of front array columns!\n");
-            return false;
-        }
-    }
-
-    b->back_array = calloc(b->rows, sizeof(unsigned *));
-    if (!b->back_array) {
-        fprintf(stderr, "Error in calloc of back array rows!\n");
+    // calloc leaves the ghost border uncovered and mine-free
+    b->cells = calloc((size_t)(b->rows + 2) * b->stride, sizeof(Uint8));
+    if (!b->cells) {
+        fprintf(stderr, "Error in calloc of board cells!\n");
         return false;
     }
 
-    for (unsigned r = 0; r < b->rows; r++) {
-        b->back_array[r] = calloc(b->columns, sizeof(unsigned));
-        if (!b->back_array[r]) {
-            fprintf(stderr, "Error in calloc of back array columns!\n");
-            return false;
-        }
+    // A cell is pushed only as it is uncovered, so the stack never holds
+    // more than every cell once.
+    b->check_stack = calloc((size_t)b->rows * b->columns, sizeof(unsigned));
+    if (!b->check_stack) {
+        fprintf(stderr, "Error in calloc of check stack!\n");
+        return false;
     }
+    b->check_count = 0;
 
     return true;
 }
 
 void board_free_arrays(struct Board *b) {
-    if (b->front_array) {
-        for (unsigned r = 0; r < b->rows; r++) {
-            if (b->front_array[r]) {
-                free(b->front_array[r]);
-            }
-        }
-        free(b->front_array);
-        b->front_array = NULL;
+    if (b->cells) {
+        free(b->cells);
+        b->cells = NULL;
     }
 
-    if (b->back_array) {
-        for (unsigned r = 0; r < b->rows; r++) {
-            if (b->back_array[r]) {
-                free(b->back_array[r]);
-            }
-        }
-        free(b->back_array);
-        b->back_array = NULL;
+    if (b->check_stack) {
+        free(b->check_stack);
+        b->check_stack = NULL;
     }
+    b->check_count = 0;
 }
 
-bool board_reset(struct Board *b, int mine_count, bool full_reset) {
+bool board_reset(struct Board *b, int mine_count) {
     b->mine_count = mine_count;
 
-    if (full_reset) {
-        board_free_arrays(b);
+    // A search started by a press in the last game is for the old board
+    generator_cancel(b->generator);
 
-        if (!board_calloc_arrays(b)) {
-            return false;
-        }
+    board_free_arrays(b);
 
-        for (unsigned r = 0; r < b->rows; r++) {
-            for (unsigned c = 0; c < b->columns; c++) {
-                b->front_array[r][c] = 9;
-            }
-        }
-    } else {
-        for (unsigned r = 0; r < b->rows; r++) {
-            for (unsigned c = 0; c < b->columns; c++) {
-                unsigned elem = b->front_array[r][c];
-                b->front_array[r][c] =
-                    ((elem == 10) || (elem == 11)) ? elem : 9;
-            }
-        }
+    if (!board_calloc_arrays(b)) {
+        return false;
     }
 
-    for (unsigned r = 0; r < b->rows; r++) {
+    // Cover every cell
+    b->flags_placed = 0;
+    b->questions_placed = 0;
+    for (unsigned r = 1; r <= b->rows; r++) {
+        Uint8 *cell = b->cells + (size_t)r * b->stride + 1;
         for (unsigned c = 0; c < b->columns; c++) {
-            b->back_array[r][c] = 0;
-        }
-    }
-
-    int add_mines = b->mine_count;
-    while (add_mines > 0) {
-        int r = rand() % (int)b->rows;
-        int c = rand() % (int)b->columns;
-        if (!b->back_array[r][c]) {
-            b->back_array[r][c] = 13;
-            add_mines--;
-        }
-    }
-
-    for (int row = 0; row < (int)b->rows; row++) {
-        for (int column = 0; column < (int)b->columns; column++) {
-            unsigned close_mines = 0;
-            if (b->back_array[row][column] == 13) {
-                continue;
-            }
-            for (int r = row - 1; r < row + 2; r++) {
-                if (r >= 0 && r < (int)b->rows) {
-                    for (int c = column - 1; c < column + 2; c++) {
-                        if (c >= 0 && c < (int)b->columns) {
-                            if (b->back_array[r][c] == 13) {
-                                close_mines++;
-                            }
-                        }
-                    }
-                }
-            }
-            b->back_array[row][column] = close_mines;
+            cell[c] = (Uint8)(CELL_COVERED << CELL_STATE_SHIFT);
         }
     }
+    // Mines are placed on the first click, so until then every cell is safe
+    b->safe_left = b->rows * b->columns;
+    b->rng_state = generator_seed(SDL_GetPerformanceCounter() ^ b->rng_state);
 
     b->game_status = 0;
     b->first_turn = true;
-    b->mines_marked = 0;
 
     return true;
 }
 
 int board_game_status(const struct Board *b) { return b->game_status; }
 
-int board_mines_marked(const struct Board *b) { return b->mines_marked; }
+int board_mines_left(const struct Board *b) {
+    return b->mine_count - (int)b->flags_placed;
+}
 
 bool board_is_pressed(const struct Board *b) { return b->pressed; }
 
-bool board_push_check(struct Board *b, int row, int column) {
-    struct Node *node = calloc(1, sizeof(struct Node));
-    if (!node) {
-        fprintf(stderr, "Error in calloc of check Node.\n");
-        return false;
+void board_set_no_guess(struct Board *b, bool no_guess) {
+    b->no_guess = no_guess;
+}
+
+// Places the mines once the first cell is known, with a partial Fisher-Yates
+// shuffle of the candidate cells: one draw per mine and no retries, however
+// dense the board. The 3x3 block around the first click is kept clear so it
+// opens an area, unless there are too few cells left for the mines; the
+// clicked cell itself is always safe.
+void board_place_mines(struct Board *b, unsigned first_index) {
+    unsigned mines = (unsigned)b->mine_count;
+
+    unsigned count = generator_mine_candidates(b->check_stack, b->rows,
+                                               b->columns, first_index, 1);
+    if (count < mines) {
+        count = generator_mine_candidates(b->check_stack, b->rows,
+                                          b->columns, first_index, 0);
+    }
+    // The counter must show the mines that exist
+    if (mines > count) {
+        mines = count;
+        b->mine_count = (int)mines;
     }
 
-    node->row = row;
-    node->column = column;
+    for (unsigned i = 0; i < mines; i++) {
+        unsigned j = i + generator_random_below(&b->rng_state, count - i);
+        unsigned index = b->check_stack[j];
+        b->check_stack[j] = b->check_stack[i];
+        b->cells[index] |= CELL_MINE;
+    }
+    b->safe_left = b->rows * b->columns - mines;
 
-    node->next = b->check_head;
-    b->check_head = node;
+    adjacency_count(b->cells, b->rows, b->columns, b->stride);
+}
 
-    return true;
+// Starts the search for a no-guess board as soon as the first press lands,
+// so the workers have until its release
+void board_start_no_guess(struct Board *b, unsigned first_index) {
+    if (!b->no_guess || !b->first_turn ||
+        generator_is_started(b->generator, first_index)) {
+        return;
+    }
+
+    Uint64 seed = ((Uint64)generator_random(&b->rng_state) << 32) |
+                  generator_random(&b->rng_state);
+    generator_start(b->generator, b->rows, b->columns, b->mine_count,
+                    first_index, seed);
 }
 
-struct Pos board_pop_check(struct Board *b) {
-    struct Pos pos;
-    if (b->check_head) {
-        pos.row = b->check_head->row;
-        pos.column = b->check_head->column;
-    } else {
-        pos.row = 0;
-        pos.column = 0;
+// Takes the board the generator found, if it found one within its budget
+bool board_place_no_guess(struct Board *b, unsigned first_index) {
+    if (!b->no_guess) {
+        return false;
     }
 
-    struct Node *node = b->check_head;
-    b->check_head = b->check_head->next;
-    free(node);
+    board_start_no_guess(b, first_index);
 
-    return pos;
+    // Out of time the caller places the mines at random instead
+    unsigned mines;
+    if (!generator_wait(b->generator, b->cells, &mines)) {
+        return false;
+    }
+    b->mine_count = (int)mines;
+    b->safe_left = b->rows * b->columns - mines;
+
+    return true;
 }
 
-bool board_uncover(struct Board *b) {
-    while (b->check_head) {
-        struct Pos pos = board_pop_check(b);
+void board_push_check(struct Board *b, unsigned index) {
+    b->check_stack[b->check_count++] = index;
+}
 
-        for (int r = pos.row - 1; r < pos.row + 2; r++) {
-            if (r < 0 || r >= (int)b->rows) {
-                continue;
-            }
-            for (int c = pos.column - 1; c < pos.column + 2; c++) {
-                if (c < 0 || c >= (int)b->columns) {
-                    continue;
-                }
-                if (b->front_array[r][c] == 9) {
-                    b->front_array[r][c] = b->back_array[r][c];
-                    if (b->front_array[r][c] == 0) {
-                        if (!board_push_check(b, r, c)) {
-                            return false;
-                        }
-                    }
+void board_uncover(struct Board *b) {
+    const unsigned stride = b->stride;
+    const unsigned neighbours[8] = {
+        0u - stride - 1, 0u - stride, 0u - stride + 1, 0u - 1,
+        1u, stride - 1, stride, stride + 1,
+    };
+
+    while (b->check_count > 0) {
+        unsigned index = b->check_stack[--b->check_count];
+
+        // Ghost cells are never covered, so the border stops the fill
+        for (unsigned n = 0; n < 8; n++) {
+            unsigned next = index + neighbours[n];
+            Uint8 *cell = &b->cells[next];
+            if (cell_state(*cell) == CELL_COVERED) {
+                cell_set_state(cell, CELL_UNCOVERED);
+                b->safe_left--;
+                if ((*cell & (CELL_MINE | CELL_COUNT_MASK)) == 0) {
+                    board_push_check(b, next);
                 }
             }
         }
     }
+}
 
-    return true;
+void board_check_won(struct Board *b) {
+    if (b->safe_left == 0) {
+        b->game_status = 1;
+    }
 }
 
-void board_reveal(struct Board *b) {
-    for (unsigned row = 0; row < b->rows; row++) {
-        for (unsigned column = 0; column < b->columns; column++) {
-            if (b->front_array[row][column] == 9 &&
-                b->back_array[row][column] == 13) {
-                b->front_array[row][column] = 13;
-            }
-            if (b->front_array[row][column] == 10 &&
-                b->back_array[row][column] != 13) {
-                b->front_array[row][column] = 15;
-            }
-        }
+// Finds the cell under the mouse; false outside the board
+bool board_cell_at(const struct Board *b, int x, int y, unsigned *index) {
+    if (x < b->rect.x || y < b->rect.y) {
+        return false;
+    }
+
+    unsigned row = (unsigned)((y - b->rect.y) / b->piece_size);
+    unsigned column = (unsigned)((x - b->rect.x) / b->piece_size);
+    if (row >= b->rows || column >= b->columns) {
+        return false;
     }
+
+    *index = (row + 1) * b->stride + column + 1;
+    return true;
 }
 
-void board_check_won(struct Board *b) {
-    for (unsigned row = 0; row < b->rows; row++) {
-        for (unsigned column = 0; column < b->columns; column++) {
-            if (b->back_array[row][column] != 13) {
-                if (b->front_array[row][column] != b->back_array[row][column]) {
-                    return;
-                }
-            }
+unsigned board_cell_sprite(const struct Board *b, unsigned index) {
+    Uint8 cell = b->cells[index];
+    unsigned state = cell_state(cell);
+
+    // Once the game is over, covered mines and wrong flags are shown as
+    // they are drawn rather than marked across the whole board
+    if (b->game_status != 0) {
+        if (state == CELL_COVERED && (cell & CELL_MINE)) {
+            state = CELL_SHOW_MINE;
+        } else if (state == CELL_FLAGGED && !(cell & CELL_MINE)) {
+            state = CELL_WRONG_FLAG;
         }
     }
-    b->game_status = 1;
+
+    return board_state_sprites[state] +
+           (state == CELL_UNCOVERED ? (cell & CELL_COUNT_MASK) : 0);
 }
 
 void board_mouse_down(struct Board *b, int x, int y, Uint8 button) {
     b->pressed = false;
 
-    if (x < b->rect.x || x > b->rect.x + b->rect.w) {
+    unsigned index;
+    if (!board_cell_at(b, x, y, &index)) {
         return;
     }
-    if (y < b->rect.y || y > b->rect.y + b->rect.h) {
-        return;
-    }
-
-    int row = (y - b->rect.y) / b->piece_size;
-    int column = (x - b->rect.x) / b->piece_size;
+    unsigned state = cell_state(b->cells[index]);
 
     if (button == SDL_BUTTON_LEFT) {
-        if (b->front_array[row][column] == 9) {
+        if (state == CELL_COVERED) {
             b->pressed = true;
+            board_start_no_guess(b, index);
         }
     } else if (button == SDL_BUTTON_RIGHT) {
-        if (b->front_array[row][column] > 8 &&
-            b->front_array[row][column] < 12) {
+        if (state == CELL_COVERED || state == CELL_FLAGGED ||
+            state == CELL_QUESTION) {
             b->pressed = true;
         }
     }
@@ -314,63 +326,54 @@ bool board_mouse_up(struct Board *b, int x, int y, Uint8 button) {
         return true;
     }
     b->pressed = false;
-    b->mines_marked = 0;
 
-    if (x < b->rect.x || x > b->rect.x + b->rect.w) {
+    unsigned index;
+    if (!board_cell_at(b, x, y, &index)) {
+        // Nothing is revealed, so a search started by the press is not needed
+        generator_cancel(b->generator);
         return true;
     }
-    if (y < b->rect.y || y > b->rect.y + b->rect.h) {
-        return true;
-    }
-
-    int row = (y - b->rect.y) / b->piece_size;
-    int column = (x - b->rect.x) / b->piece_size;
+    Uint8 *cell = &b->cells[index];
 
     if (button == SDL_BUTTON_LEFT) {
-        if (b->front_array[row][column] == 9) {
-            while (true) {
-                if (b->back_array[row][column] == 13) {
-                    b->game_status = -1;
-                    b->front_array[row][column] = 14;
-                } else {
-                    b->front_array[row][column] = b->back_array[row][column];
-                    if (b->front_array[row][column] == 0) {
-                        if (!board_push_check(b, row, column)) {
-                            return false;
-                        }
-                        if (!board_uncover(b)) {
-                            return false;
-                        }
-                    }
-                    board_check_won(b);
-                }
-                if (b->first_turn && b->game_status != 0) {
-                    if (!board_reset(b, b->mine_count, false)) {
-                        return false;
-                    }
-                } else {
-                    break;
+        if (cell_state(*cell) == CELL_COVERED) {
+            if (b->first_turn) {
+                if (!board_place_no_guess(b, index)) {
+                    board_place_mines(b, index);
                 }
+                b->first_turn = false;
             }
-            b->first_turn = false;
 
-            if (b->game_status != 0) {
-                board_reveal(b);
+            if (*cell & CELL_MINE) {
+                b->game_status = -1;
+                cell_set_state(cell, CELL_EXPLODED);
+            } else {
+                cell_set_state(cell, CELL_UNCOVERED);
+                b->safe_left--;
+                if ((*cell & CELL_COUNT_MASK) == 0) {
+                    board_push_check(b, index);
+                    board_uncover(b);
+                }
+                board_check_won(b);
             }
 
             return true;
         }
+        generator_cancel(b->generator);
     }
 
     if (button == SDL_BUTTON_RIGHT) {
-        if (b->front_array[row][column] == 9) {
-            b->front_array[row][column]++;
-            b->mines_marked = -1;
-        } else if (b->front_array[row][column] == 10) {
-            b->front_array[row][column]++;
-            b->mines_marked = 1;
-        } else if (b->front_array[row][column] == 11) {
-            b->front_array[row][column] = 9;
+        unsigned state = cell_state(*cell);
+        if (state == CELL_COVERED) {
+            cell_set_state(cell, CELL_FLAGGED);
+            b->flags_placed++;
+        } else if (state == CELL_FLAGGED) {
+            cell_set_state(cell, CELL_QUESTION);
+            b->flags_placed--;
+            b->questions_placed++;
+        } else if (state == CELL_QUESTION) {
+            cell_set_state(cell, CELL_COVERED);
+            b->questions_placed--;
         }
     }
 
@@ -400,9 +403,10 @@ void board_draw(const struct Board *b) {
     SDL_Rect dest_rect = {0, 0, b->piece_size, b->piece_size};
     for (unsigned r = 0; r < b->rows; r++) {
         dest_rect.y = (int)r * dest_rect.h + b->rect.y;
+        unsigned index = (r + 1) * b->stride + 1;
         for (unsigned c = 0; c < b->columns; c++) {
             dest_rect.x = (int)c * dest_rect.w + b->rect.x;
-            unsigned rect_index = b->front_array[r][c];
+            unsigned rect_index = board_cell_sprite(b, index + c);
             SDL_RenderCopy(b->renderer, b->image,
                            &b->src_rects[rect_index + b->theme], &dest_rect);
         }
@@ -2,45 +2,63 @@
 #define BOARD_H
 
 #include "main.h"
+#include "generator.h"
+
+// Each cell is one byte: the adjacent mine count, the mine bit and what the
+// player sees. The cells are stored row by row with a one-cell ghost border,
+// so neighbour loops run without bounds checks. Ghost cells are uncovered,
+// mine-free and never drawn.
+#define CELL_COUNT_MASK 0x0Fu
+#define CELL_MINE 0x10u
+#define CELL_STATE_SHIFT 5
+#define CELL_STATE_MASK 0xE0u
+
+enum CellState {
+    CELL_UNCOVERED = 0, // Shows the adjacent count
+    CELL_COVERED,
+    CELL_FLAGGED,
+    CELL_QUESTION,
+    CELL_SHOW_MINE,     // Drawn for a covered mine once the game is over
+    CELL_EXPLODED,      // The mine that was clicked
+    CELL_WRONG_FLAG     // Drawn for a flag on a safe cell once the game is over
+};
 
 struct Board {
         SDL_Renderer *renderer;
         SDL_Texture *image;
         SDL_Rect *src_rects;
-        unsigned **front_array;
-        unsigned **back_array;
+        Uint8 *cells;               // (rows + 2) x (columns + 2), see CELL_*
+        unsigned stride;            // columns + 2
         SDL_Rect rect;
         unsigned rows;
         unsigned columns;
         int scale;
         int piece_size;
         int mine_count;
-        struct Node *check_head;
+        unsigned *check_stack;      // Flood fill cells to expand, as cell indices
+        unsigned check_count;
         bool pressed;
-        int mines_marked;
+        unsigned safe_left;         // Safe cells not yet uncovered
+        unsigned flags_placed;
+        unsigned questions_placed;
         int game_status;
         bool first_turn;
+        bool no_guess;              // Only deal boards the solver can clear
+        struct Generator *generator;
+        Uint64 rng_state;           // Reseeded for each game, see generator.h
         unsigned theme;
 };
 
-struct Node {
-        struct Node *next;
-        int row;
-        int column;
-};
-
-struct Pos {
-        int row;
-        int column;
-};
-
 bool board_new(struct Board **board, SDL_Renderer *renderer, unsigned rows,
                unsigned columns, int scale, int mine_count);
 void board_free(struct Board **board);
-bool board_reset(struct Board *b, int mine_count, bool full_reset);
+bool board_reset(struct Board *b, int mine_count);
 int board_game_status(const struct Board *b);
-int board_mines_marked(const struct Board *b);
+// Mines less flags placed, as shown by the mine counter
+int board_mines_left(const struct Board *b);
 bool board_is_pressed(const struct Board *b);
+// Takes effect from the next first click
+void board_set_no_guess(struct Board *b, bool no_guess);
 void board_mouse_down(struct Board *b, int x, int y, Uint8 button);
 bool board_mouse_up(struct Board *b, int x, int y, Uint8 button);
 void board_set_scale(struct Board *b, int scale);
@@ -12,6 +12,7 @@ bool game_reset(struct Game *g);
 void game_set_scale(struct Game *g);
 void game_toggel_scale(struct Game *g);
 void game_set_theme(struct Game *g, unsigned theme);
+bool game_toggle_no_guess(struct Game *g);
 bool game_set_difficulty(struct Game *g, double difficulty,
                          const char *diff_str);
 bool game_set_size(struct Game *g, unsigned rows, unsigned columns, int scale,
@@ -56,6 +57,7 @@ bool game_new(struct Game **game) {
     g->scale = 2;
     g->mine_count = 8;
     g->difficulty = 0.1;
+    g->no_guess = true;
 
     if (!game_init_sdl(g)) {
         return false;
@@ -69,6 +71,7 @@ bool game_new(struct Game **game) {
                    g->mine_count)) {
         return false;
     }
+    board_set_no_guess(g->board, g->no_guess);
 
     if (!mines_new(&g->mines, g->renderer, g->scale, g->mine_count)) {
         return false;
@@ -157,13 +160,14 @@ bool game_create_string(char **game_str, const char *new_str) {
 }
 
 void game_set_title(struct Game *g) {
-    int length = snprintf(NULL, 0, "%s - %s - %s", WINDOW_TITLE, g->size_str,
-                          g->diff_str) +
+    const char *guess_str = g->no_guess ? " - No Guess" : "";
+    int length = snprintf(NULL, 0, "%s - %s - %s%s", WINDOW_TITLE, g->size_str,
+                          g->diff_str, guess_str) +
                  1;
     char title_str[length];
 
-    snprintf(title_str, (size_t)length, "%s - %s - %s", WINDOW_TITLE,
-             g->size_str, g->diff_str);
+    snprintf(title_str, (size_t)length, "%s - %s - %s%s", WINDOW_TITLE,
+             g->size_str, g->diff_str, guess_str);
 
     SDL_SetWindowTitle(g->window, title_str);
 }
@@ -171,7 +175,7 @@ void game_set_title(struct Game *g) {
 bool game_reset(struct Game *g) {
     g->mine_count = (int)((double)(g->rows * g->columns) * g->difficulty);
 
-    if (!board_reset(g->board, g->mine_count, true)) {
+    if (!board_reset(g->board, g->mine_count)) {
         return false;
     }
 
@@ -219,6 +223,17 @@ void game_set_theme(struct Game *g, unsigned theme) {
     face_set_theme(g->face, face_theme);
 }
 
+bool game_toggle_no_guess(struct Game *g) {
+    g->no_guess = !g->no_guess;
+    board_set_no_guess(g->board, g->no_guess);
+
+    if (!game_reset(g)) {
+        return false;
+    }
+
+    return true;
+}
+
 bool game_set_size(struct Game *g, unsigned rows, unsigned columns, int scale,
                    const char *size_str) {
     g->rows = rows;
@@ -285,11 +300,7 @@ bool game_mouse_up(struct Game *g, int x, int y, Uint8 button) {
             return false;
         }
 
-        if (board_mines_marked(g->board) == 1) {
-            mines_increment(g->mines);
-        } else if (board_mines_marked(g->board) == -1) {
-            mines_decrement(g->mines);
-        }
+        mines_reset(g->mines, board_mines_left(g->board));
 
         if (board_game_status(g->board) == 1) {
             face_won(g->face);
@@ -334,6 +345,11 @@ bool game_events(struct Game *g) {
                     return false;
                 }
                 break;
+            case SDL_SCANCODE_G:
+                if (!game_toggle_no_guess(g)) {
+                    return false;
+                }
+                break;
             case SDL_SCANCODE_1:
                 game_set_theme(g, 0);
                 break;
@@ -24,6 +24,7 @@ struct Game {
         int scale;
         int mine_count;
         double difficulty;
+        bool no_guess;
         char *size_str;
         char *diff_str;
 };
@@ -0,0 +1,393 @@
+#include "generator.h"
+#include "adjacency.h"
+#include "board.h"
+
+int generator_worker_run(void *data);
+bool generator_worker_prepare(struct GeneratorWorker *w,
+                              const struct GeneratorJob *job);
+bool generator_attempt(struct GeneratorWorker *w,
+                       const struct GeneratorJob *job);
+void generator_store(struct Generator *g, const struct GeneratorWorker *w);
+
+// Workers give up on a job once its budget is spent, whether or not anyone
+// waits for it
+static inline bool generator_expired(const struct GeneratorJob *job) {
+    return SDL_TICKS_PASSED(SDL_GetTicks(),
+                            job->start_time + GENERATOR_BUDGET_MS);
+}
+
+bool generator_new(struct Generator **generator) {
+    *generator = calloc(1, sizeof(struct Generator));
+    if (!*generator) {
+        fprintf(stderr, "Error in calloc of new generator.\n");
+        return false;
+    }
+    struct Generator *g = *generator;
+
+    g->mutex = SDL_CreateMutex();
+    g->work_ready = SDL_CreateCond();
+    g->board_ready = SDL_CreateCond();
+    if (!g->mutex || !g->work_ready || !g->board_ready) {
+        fprintf(stderr, "Error creating generator lock: %s\n", SDL_GetError());
+        return false;
+    }
+
+    // Leave a core for the game itself
+    unsigned thread_count = 0;
+#ifndef WASM_BUILD
+    int cpu_count = SDL_GetCPUCount();
+    thread_count = cpu_count > 2 ? (unsigned)cpu_count - 1 : 1;
+    if (thread_count > GENERATOR_MAX_THREADS) {
+        thread_count = GENERATOR_MAX_THREADS;
+    }
+#endif
+
+    // Without threads worker 0 samples on the waiting thread
+    g->workers = calloc(thread_count ? thread_count : 1,
+                        sizeof(struct GeneratorWorker));
+    if (!g->workers) {
+        fprintf(stderr, "Error in calloc of generator workers!\n");
+        return false;
+    }
+    for (unsigned i = 0; i < (thread_count ? thread_count : 1); i++) {
+        g->workers[i].generator = g;
+    }
+
+    // Fewer threads than asked for still work, only slower
+    for (unsigned i = 0; i < thread_count; i++) {
+        g->workers[i].thread = SDL_CreateThread(generator_worker_run,
+                                                "generator", &g->workers[i]);
+        if (!g->workers[i].thread) {
+            fprintf(stderr, "Error creating generator thread: %s\n",
+                    SDL_GetError());
+            break;
+        }
+        g->thread_count++;
+    }
+
+    return true;
+}
+
+void generator_free(struct Generator **generator) {
+    if (*generator) {
+        struct Generator *g = *generator;
+
+        if (g->mutex) {
+            SDL_LockMutex(g->mutex);
+            g->quit = true;
+            if (g->work_ready) {
+                SDL_CondBroadcast(g->work_ready);
+            }
+            SDL_UnlockMutex(g->mutex);
+        }
+
+        if (g->workers) {
+            for (unsigned i = 0; i < (g->thread_count ? g->thread_count : 1);
+                 i++) {
+                struct GeneratorWorker *w = &g->workers[i];
+                if (w->thread) {
+                    SDL_WaitThread(w->thread, NULL);
+                    w->thread = NULL;
+                }
+                solver_free(&w->solver);
+                free(w->cells);
+                free(w->candidates);
+            }
+            free(g->workers);
+            g->workers = NULL;
+        }
+
+        if (g->board) {
+            free(g->board);
+            g->board = NULL;
+        }
+
+        if (g->board_ready) {
+            SDL_DestroyCond(g->board_ready);
+            g->board_ready = NULL;
+        }
+
+        if (g->work_ready) {
+            SDL_DestroyCond(g->work_ready);
+            g->work_ready = NULL;
+        }
+
+        if (g->mutex) {
+            SDL_DestroyMutex(g->mutex);
+            g->mutex = NULL;
+        }
+
+        free(*generator);
+        *generator = NULL;
+    }
+}
+
+// splitmix64's finaliser spreads weak entropy over the whole state
+Uint64 generator_seed(Uint64 entropy) {
+    entropy += 0x9E3779B97F4A7C15ULL;
+    entropy = (entropy ^ (entropy >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    entropy = (entropy ^ (entropy >> 27)) * 0x94D049BB133111EBULL;
+    entropy ^= entropy >> 31;
+    return entropy ? entropy : 1;
+}
+
+// xorshift64*; each worker draws from its own stream without locking
+Uint32 generator_random(Uint64 *state) {
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return (Uint32)((*state * 0x2545F4914F6CDD1DULL) >> 32);
+}
+
+// Lemire's multiply and shift, redrawing the few values that would make
+// some results more likely than others
+unsigned generator_random_below(Uint64 *state, unsigned bound) {
+    Uint64 product = (Uint64)generator_random(state) * bound;
+    Uint32 low = (Uint32)product;
+    if (low < bound) {
+        Uint32 threshold = (Uint32)(0u - bound) % bound;
+        while (low < threshold) {
+            product = (Uint64)generator_random(state) * bound;
+            low = (Uint32)product;
+        }
+    }
+    return (unsigned)(product >> 32);
+}
+
+unsigned generator_mine_candidates(unsigned *candidates, unsigned rows,
+                                   unsigned columns, unsigned first_index,
+                                   unsigned clear_radius) {
+    unsigned stride = columns + 2;
+    unsigned first_row = first_index / stride;
+    unsigned first_column = first_index % stride;
+    unsigned count = 0;
+
+    for (unsigned r = 1; r <= rows; r++) {
+        bool row_clear =
+            r + clear_radius >= first_row && r <= first_row + clear_radius;
+        for (unsigned c = 1; c <= columns; c++) {
+            if (row_clear && c + clear_radius >= first_column &&
+                c <= first_column + clear_radius) {
+                continue;
+            }
+            candidates[count++] = r * stride + c;
+        }
+    }
+
+    return count;
+}
+
+bool generator_start(struct Generator *g, unsigned rows, unsigned columns,
+                     int mine_count, unsigned start_index, Uint64 seed) {
+    size_t board_size = (size_t)(rows + 2) * (columns + 2);
+    bool started = true;
+
+    SDL_LockMutex(g->mutex);
+
+    if (g->board_size != board_size) {
+        free(g->board);
+        g->board_size = 0;
+        g->board = calloc(board_size, sizeof(Uint8));
+        if (!g->board) {
+            fprintf(stderr, "Error in calloc of generator board!\n");
+            started = false;
+            goto cleanup;
+        }
+        g->board_size = board_size;
+    }
+
+    g->job.id++;
+    g->job.rows = rows;
+    g->job.columns = columns;
+    g->job.mine_count = (unsigned)mine_count;
+    g->job.start_index = start_index;
+    g->job.seed = seed;
+    g->job.start_time = SDL_GetTicks();
+    g->active = true;
+    g->found = false;
+
+    SDL_CondBroadcast(g->work_ready);
+
+cleanup:
+    if (!started) {
+        g->active = false;
+    }
+    SDL_UnlockMutex(g->mutex);
+
+    return started;
+}
+
+bool generator_is_started(const struct Generator *g, unsigned start_index) {
+    return g->active && g->job.start_index == start_index;
+}
+
+void generator_cancel(struct Generator *g) {
+    SDL_LockMutex(g->mutex);
+    g->active = false;
+    SDL_UnlockMutex(g->mutex);
+}
+
+bool generator_wait(struct Generator *g, Uint8 *cells, unsigned *mines_placed) {
+    SDL_LockMutex(g->mutex);
+
+    if (!g->active) {
+        SDL_UnlockMutex(g->mutex);
+        return false;
+    }
+    Uint32 deadline = g->job.start_time + GENERATOR_BUDGET_MS;
+
+    if (g->thread_count == 0) {
+        struct GeneratorWorker *w = &g->workers[0];
+        struct GeneratorJob job = g->job;
+        SDL_UnlockMutex(g->mutex);
+
+        bool found = false;
+        if (generator_worker_prepare(w, &job)) {
+            while (!found && !generator_expired(&job)) {
+                found = generator_attempt(w, &job);
+            }
+        }
+
+        SDL_LockMutex(g->mutex);
+        if (found) {
+            generator_store(g, w);
+        }
+    }
+
+    while (!g->found) {
+        Uint32 now = SDL_GetTicks();
+        if (SDL_TICKS_PASSED(now, deadline)) {
+            break;
+        }
+        SDL_CondWaitTimeout(g->board_ready, g->mutex, deadline - now);
+    }
+
+    bool found = g->found;
+    if (found) {
+        for (size_t i = 0; i < g->board_size; i++) {
+            cells[i] = (Uint8)((cells[i] & CELL_STATE_MASK) | g->board[i]);
+        }
+        *mines_placed = g->mines_placed;
+    }
+    g->active = false;
+
+    SDL_UnlockMutex(g->mutex);
+
+    return found;
+}
+
+int generator_worker_run(void *data) {
+    struct GeneratorWorker *w = data;
+    struct Generator *g = w->generator;
+
+    SDL_LockMutex(g->mutex);
+    while (!g->quit) {
+        if (!g->active || g->found || g->job.id == w->job_id ||
+            generator_expired(&g->job)) {
+            SDL_CondWait(g->work_ready, g->mutex);
+            continue;
+        }
+
+        struct GeneratorJob job = g->job;
+        w->job_id = job.id;
+        SDL_UnlockMutex(g->mutex);
+
+        // Sample until some worker finds a board, the job changes or its
+        // budget runs out; the lock is only taken between attempts
+        bool current = generator_worker_prepare(w, &job);
+        while (current) {
+            bool found = generator_attempt(w, &job);
+
+            SDL_LockMutex(g->mutex);
+            current = !g->quit && g->active && !g->found &&
+                      g->job.id == job.id && !generator_expired(&job);
+            if (found && current) {
+                generator_store(g, w);
+                current = false;
+            }
+            SDL_UnlockMutex(g->mutex);
+        }
+
+        SDL_LockMutex(g->mutex);
+    }
+    SDL_UnlockMutex(g->mutex);
+
+    return 0;
+}
+
+// Sizes the worker's buffers for the job and seeds its own stream
+bool generator_worker_prepare(struct GeneratorWorker *w,
+                              const struct GeneratorJob *job) {
+    if (w->rows != job->rows || w->columns != job->columns || !w->solver) {
+        solver_free(&w->solver);
+        free(w->cells);
+        free(w->candidates);
+        w->rows = 0;
+        w->columns = 0;
+
+        size_t cell_count = (size_t)(job->rows + 2) * (job->columns + 2);
+        w->cells = calloc(cell_count, sizeof(Uint8));
+        w->candidates = calloc((size_t)job->rows * job->columns,
+                               sizeof(unsigned));
+        if (!w->cells || !w->candidates) {
+            fprintf(stderr, "Error in calloc of generator worker!\n");
+            return false;
+        }
+        if (!solver_new(&w->solver, job->rows, job->columns)) {
+            return false;
+        }
+        w->rows = job->rows;
+        w->columns = job->columns;
+    }
+
+    // Same placement rule as the board: keep the 3x3 block around the first
+    // click clear when there is room
+    w->candidate_count = generator_mine_candidates(
+        w->candidates, job->rows, job->columns, job->start_index, 1);
+    if (w->candidate_count < job->mine_count) {
+        w->candidate_count = generator_mine_candidates(
+            w->candidates, job->rows, job->columns, job->start_index, 0);
+    }
+    w->mine_count = job->mine_count < w->candidate_count ? job->mine_count
+                                                         : w->candidate_count;
+
+    // Worker streams differ by index
+    unsigned index = (unsigned)(w - w->generator->workers);
+    w->rng_state = generator_seed(job->seed + index);
+
+    return true;
+}
+
+// Places the mines with a partial Fisher-Yates shuffle, counts them and asks
+// the solver whether the layout can be cleared from the first click
+bool generator_attempt(struct GeneratorWorker *w,
+                       const struct GeneratorJob *job) {
+    unsigned stride = job->columns + 2;
+    size_t cell_count = (size_t)(job->rows + 2) * stride;
+    for (size_t i = 0; i < cell_count; i++) {
+        w->cells[i] = 0;
+    }
+
+    for (unsigned i = 0; i < w->mine_count; i++) {
+        unsigned j =
+            i + generator_random_below(&w->rng_state, w->candidate_count - i);
+        unsigned index = w->candidates[j];
+        w->candidates[j] = w->candidates[i];
+        w->candidates[i] = index;
+        w->cells[index] |= CELL_MINE;
+    }
+
+    adjacency_count(w->cells, job->rows, job->columns, stride);
+
+    return solver_solve(w->solver, w->cells, job->start_index);
+}
+
+// Called with the lock held
+void generator_store(struct Generator *g, const struct GeneratorWorker *w) {
+    for (size_t i = 0; i < g->board_size; i++) {
+        g->board[i] = w->cells[i];
+    }
+    g->mines_placed = w->mine_count;
+    g->found = true;
+    SDL_CondBroadcast(g->board_ready);
+}
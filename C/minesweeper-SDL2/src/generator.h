@@ -0,0 +1,80 @@
+#ifndef GENERATOR_H
+#define GENERATOR_H
+
+#include "main.h"
+#include "solver.h"
+
+// Samples mine layouts for a known first click until the solver clears one
+// without guessing. Workers on their own threads sample in parallel, so the
+// search can start when the first press lands and be done by its release.
+// Builds without threads (WASM) sample on the caller's thread while it waits.
+// A job is dropped once GENERATOR_BUDGET_MS have passed since it started,
+// even if nobody waits for it.
+
+#define GENERATOR_MAX_THREADS 8
+#define GENERATOR_BUDGET_MS 1500
+
+struct GeneratorJob {
+        unsigned id;                // Changes with every request
+        unsigned rows;
+        unsigned columns;
+        unsigned mine_count;
+        unsigned start_index;
+        Uint64 seed;
+        Uint32 start_time;
+};
+
+struct GeneratorWorker {
+        struct Generator *generator;
+        SDL_Thread *thread;
+        struct Solver *solver;
+        Uint8 *cells;               // Layout being tried, board layout
+        unsigned *candidates;       // Cells a mine may go in for the job
+        unsigned candidate_count;
+        unsigned mine_count;        // Mines to place, at most the candidates
+        unsigned rows;              // Size the buffers above are for
+        unsigned columns;
+        unsigned job_id;            // Last job this worker took
+        Uint64 rng_state;
+};
+
+struct Generator {
+        SDL_mutex *mutex;
+        SDL_cond *work_ready;       // A job was requested, or quit
+        SDL_cond *board_ready;      // A worker found a board
+        struct GeneratorWorker *workers;
+        unsigned thread_count;      // 0 when sampling on the waiting thread
+        struct GeneratorJob job;
+        bool active;                // The job still wants a board
+        bool found;
+        bool quit;
+        Uint8 *board;               // Mine bits and counts of the board found
+        size_t board_size;
+        unsigned mines_placed;
+};
+
+bool generator_new(struct Generator **generator);
+void generator_free(struct Generator **generator);
+// Starts looking for a board that can be solved from start_index
+bool generator_start(struct Generator *g, unsigned rows, unsigned columns,
+                     int mine_count, unsigned start_index, Uint64 seed);
+bool generator_is_started(const struct Generator *g, unsigned start_index);
+// Waits until the job's time budget runs out for a board, then stops the
+// job. On success the mine bits and counts replace those in cells and
+// mines_placed is set.
+bool generator_wait(struct Generator *g, Uint8 *cells, unsigned *mines_placed);
+void generator_cancel(struct Generator *g);
+// xorshift64* streams, so mine placement does not depend on the C library's
+// rand() and its range. The state must never be zero; generator_seed makes
+// one from any value.
+Uint64 generator_seed(Uint64 entropy);
+Uint32 generator_random(Uint64 *state);
+// Uniform in [0, bound), bound > 0
+unsigned generator_random_below(Uint64 *state, unsigned bound);
+// Lists the cells further than clear_radius rows or columns from
+// first_index, the places a mine may go, and returns how many there are
+unsigned generator_mine_candidates(unsigned *candidates, unsigned rows,
+                                   unsigned columns, unsigned first_index,
+                                   unsigned clear_radius);
+
+#endif
@@ -103,16 +103,6 @@ void mines_reset(struct Mines *m, int mine_count) {
     mines_update_digits(m);
 }
 
-void mines_increment(struct Mines *m) {
-    m->mine_count++;
-    mines_update_digits(m);
-}
-
-void mines_decrement(struct Mines *m) {
-    m->mine_count--;
-    mines_update_digits(m);
-}
-
 void mines_set_scale(struct Mines *m, int scale) {
     m->scale = scale;
     m->back_dest_rect.x = DIGIT_BACK_LEFT * m->scale;
@@ -0,0 +1,551 @@
+#include "solver.h"
+#include "board.h"
+
+#define SOLVER_NO_TAG ((unsigned)-1)
+#define SOLVER_ENUM_CONSTRAINTS (SOLVER_ENUM_CELLS * 8)
+
+// Search state for one frontier component
+struct SolverEnum {
+        unsigned variable_count;
+        unsigned constraint_count;
+        int needed[SOLVER_ENUM_CONSTRAINTS];    // Mines a number still needs
+        int assigned[SOLVER_ENUM_CONSTRAINTS];  // Mines placed around it
+        int unassigned[SOLVER_ENUM_CONSTRAINTS]; // Cells not yet decided
+        unsigned links[SOLVER_ENUM_CELLS][8];   // Numbers around each cell
+        unsigned link_count[SOLVER_ENUM_CELLS];
+        bool mine[SOLVER_ENUM_CELLS];
+        unsigned long mine_layouts[SOLVER_ENUM_CELLS];
+        unsigned long layouts;
+        unsigned long steps;
+        unsigned mines;
+        unsigned mines_left;
+};
+
+void solver_queue(struct Solver *s, unsigned index);
+void solver_queue_around(struct Solver *s, unsigned index);
+void solver_push_safe(struct Solver *s, unsigned index);
+void solver_open_stack(struct Solver *s);
+void solver_mark_mine(struct Solver *s, unsigned index);
+unsigned solver_covered_around(const struct Solver *s, unsigned index,
+                               unsigned *covered, int *needed);
+bool solver_single_rules(struct Solver *s);
+bool solver_global_rules(struct Solver *s);
+bool solver_pair_rules(struct Solver *s);
+bool solver_pair(struct Solver *s, const unsigned *a_covered, unsigned a_count,
+                 int a_needed, unsigned b);
+bool solver_enumerate(struct Solver *s);
+bool solver_enumerate_component(struct Solver *s, struct SolverEnum *e);
+bool solver_backtrack(struct SolverEnum *e, unsigned v);
+
+bool solver_new(struct Solver **solver, unsigned rows, unsigned columns) {
+    *solver = calloc(1, sizeof(struct Solver));
+    if (!*solver) {
+        fprintf(stderr, "Error in calloc of new solver.\n");
+        return false;
+    }
+    struct Solver *s = *solver;
+
+    s->rows = rows;
+    s->columns = columns;
+    s->stride = columns + 2;
+
+    const unsigned stride = s->stride;
+    const unsigned neighbours[8] = {
+        0u - stride - 1, 0u - stride, 0u - stride + 1, 0u - 1,
+        1u, stride - 1, stride, stride + 1,
+    };
+    for (unsigned n = 0; n < 8; n++) {
+        s->neighbours[n] = neighbours[n];
+    }
+
+    size_t cell_count = (size_t)(rows + 2) * stride;
+    s->known = calloc(cell_count, sizeof(Uint8));
+    s->queue = calloc(cell_count, sizeof(unsigned));
+    s->queued = calloc(cell_count, sizeof(bool));
+    s->stack = calloc(cell_count, sizeof(unsigned));
+    s->tag = calloc(cell_count, sizeof(unsigned));
+    s->variables = calloc(cell_count, sizeof(unsigned));
+    s->constraints = calloc(cell_count, sizeof(unsigned));
+    if (!s->known || !s->queue || !s->queued || !s->stack || !s->tag ||
+        !s->variables || !s->constraints) {
+        fprintf(stderr, "Error in calloc of solver arrays!\n");
+        return false;
+    }
+
+    return true;
+}
+
+void solver_free(struct Solver **solver) {
+    if (*solver) {
+        struct Solver *s = *solver;
+
+        free(s->known);
+        free(s->queue);
+        free(s->queued);
+        free(s->stack);
+        free(s->tag);
+        free(s->variables);
+        free(s->constraints);
+
+        free(*solver);
+        *solver = NULL;
+    }
+}
+
+void solver_queue(struct Solver *s, unsigned index) {
+    if (!s->queued[index]) {
+        s->queued[index] = true;
+        s->queue[s->queue_count++] = index;
+    }
+}
+
+// An open number's covered neighbours changed, so its rule may now apply
+void solver_queue_around(struct Solver *s, unsigned index) {
+    for (unsigned n = 0; n < 8; n++) {
+        unsigned next = index + s->neighbours[n];
+        if (s->known[next] == SOLVER_OPEN) {
+            solver_queue(s, next);
+        }
+    }
+}
+
+// Cells are marked as they are pushed, as the board's flood fill does, so
+// each one is on the stack at most once
+void solver_push_safe(struct Solver *s, unsigned index) {
+    if (s->known[index] == SOLVER_COVERED) {
+        s->known[index] = SOLVER_SAFE;
+        s->stack[s->stack_count++] = index;
+    }
+}
+
+// Opens every cell pushed as safe, flooding out from zeros as the board does
+void solver_open_stack(struct Solver *s) {
+    while (s->stack_count > 0) {
+        unsigned index = s->stack[--s->stack_count];
+        if (s->cells[index] & CELL_MINE) {
+            s->contradiction = true;
+            return;
+        }
+
+        s->known[index] = SOLVER_OPEN;
+        s->safe_left--;
+        s->covered--;
+        solver_queue(s, index);
+        solver_queue_around(s, index);
+
+        if ((s->cells[index] & CELL_COUNT_MASK) == 0) {
+            for (unsigned n = 0; n < 8; n++) {
+                solver_push_safe(s, index + s->neighbours[n]);
+            }
+        }
+    }
+}
+
+void solver_mark_mine(struct Solver *s, unsigned index) {
+    if (!(s->cells[index] & CELL_MINE)) {
+        s->contradiction = true;
+        return;
+    }
+
+    s->known[index] = SOLVER_MINE;
+    s->mines_left--;
+    s->covered--;
+    solver_queue_around(s, index);
+}
+
+// Lists the covered neighbours of an open number and how many of them are
+// mines, and returns how many there are
+unsigned solver_covered_around(const struct Solver *s, unsigned index,
+                               unsigned *covered, int *needed) {
+    unsigned count = 0;
+    *needed = (int)(s->cells[index] & CELL_COUNT_MASK);
+
+    for (unsigned n = 0; n < 8; n++) {
+        unsigned next = index + s->neighbours[n];
+        if (s->known[next] == SOLVER_COVERED) {
+            covered[count++] = next;
+        } else if (s->known[next] == SOLVER_MINE) {
+            (*needed)--;
+        }
+    }
+
+    return count;
+}
+
+// A number with all its mines found frees the rest of its neighbours, and
+// one needing as many mines as it has covered neighbours mines them all
+bool solver_single_rules(struct Solver *s) {
+    bool progress = false;
+
+    while (s->queue_count > 0 && !s->contradiction) {
+        unsigned index = s->queue[--s->queue_count];
+        s->queued[index] = false;
+
+        unsigned covered[8];
+        int needed;
+        unsigned count = solver_covered_around(s, index, covered, &needed);
+        if (count == 0) {
+            continue;
+        }
+
+        if (needed == 0) {
+            for (unsigned i = 0; i < count; i++) {
+                solver_push_safe(s, covered[i]);
+            }
+            solver_open_stack(s);
+            progress = true;
+        } else if (needed == (int)count) {
+            for (unsigned i = 0; i < count; i++) {
+                solver_mark_mine(s, covered[i]);
+            }
+            progress = true;
+        }
+    }
+
+    return progress;
+}
+
+// Once every mine is found the rest is safe, and once the covered cells are
+// all mines they can be marked
+bool solver_global_rules(struct Solver *s) {
+    if (s->mines_left != 0 && s->mines_left != s->covered) {
+        return false;
+    }
+
+    for (unsigned r = 1; r <= s->rows; r++) {
+        for (unsigned c = 1; c <= s->columns; c++) {
+            unsigned index = r * s->stride + c;
+            if (s->known[index] != SOLVER_COVERED) {
+                continue;
+            }
+            if (s->mines_left == 0) {
+                solver_push_safe(s, index);
+            } else {
+                solver_mark_mine(s, index);
+            }
+        }
+    }
+    solver_open_stack(s);
+
+    return true;
+}
+
+// If number b needs exactly as many more mines than number a as it has
+// cells a does not share, those cells are mines and a's unshared cells are
+// safe. With a's cells inside b's this is the usual subset rule.
+bool solver_pair(struct Solver *s, const unsigned *a_covered, unsigned a_count,
+                 int a_needed, unsigned b) {
+    unsigned b_covered[8];
+    int b_needed;
+    unsigned b_count = solver_covered_around(s, b, b_covered, &b_needed);
+    if (b_count == 0) {
+        return false;
+    }
+
+    unsigned a_only[8];
+    unsigned b_only[8];
+    unsigned a_only_count = 0;
+    unsigned b_only_count = 0;
+    for (unsigned i = 0; i < a_count; i++) {
+        bool shared = false;
+        for (unsigned j = 0; j < b_count; j++) {
+            shared = shared || a_covered[i] == b_covered[j];
+        }
+        if (!shared) {
+            a_only[a_only_count++] = a_covered[i];
+        }
+    }
+    for (unsigned j = 0; j < b_count; j++) {
+        bool shared = false;
+        for (unsigned i = 0; i < a_count; i++) {
+            shared = shared || a_covered[i] == b_covered[j];
+        }
+        if (!shared) {
+            b_only[b_only_count++] = b_covered[j];
+        }
+    }
+
+    if (a_only_count + b_only_count == 0 ||
+        a_only_count + b_only_count == a_count + b_count ||
+        b_needed - a_needed != (int)b_only_count) {
+        return false;
+    }
+
+    for (unsigned j = 0; j < b_only_count; j++) {
+        solver_mark_mine(s, b_only[j]);
+    }
+    for (unsigned i = 0; i < a_only_count; i++) {
+        solver_push_safe(s, a_only[i]);
+    }
+    solver_open_stack(s);
+
+    return true;
+}
+
+bool solver_pair_rules(struct Solver *s) {
+    for (unsigned r = 1; r <= s->rows; r++) {
+        for (unsigned c = 1; c <= s->columns; c++) {
+            unsigned a = r * s->stride + c;
+            if (s->known[a] != SOLVER_OPEN) {
+                continue;
+            }
+
+            unsigned a_covered[8];
+            int a_needed;
+            unsigned a_count =
+                solver_covered_around(s, a, a_covered, &a_needed);
+            if (a_count == 0) {
+                continue;
+            }
+
+            // Numbers further than two cells apart share no neighbours
+            unsigned first_row = r > 2 ? r - 2 : 1;
+            unsigned last_row = r + 2 < s->rows ? r + 2 : s->rows;
+            unsigned first_column = c > 2 ? c - 2 : 1;
+            unsigned last_column = c + 2 < s->columns ? c + 2 : s->columns;
+            for (unsigned br = first_row; br <= last_row; br++) {
+                for (unsigned bc = first_column; bc <= last_column; bc++) {
+                    unsigned b = br * s->stride + bc;
+                    if (b != a && s->known[b] == SOLVER_OPEN &&
+                        solver_pair(s, a_covered, a_count, a_needed, b)) {
+                        return true;
+                    }
+                }
+            }
+        }
+    }
+
+    return false;
+}
+
+// Tries both values of cell v and, below it, every later cell, counting the
+// layouts that satisfy every number. False once the step budget runs out.
+bool solver_backtrack(struct SolverEnum *e, unsigned v) {
+    if (++e->steps > SOLVER_ENUM_STEPS) {
+        return false;
+    }
+
+    if (v == e->variable_count) {
+        e->layouts++;
+        for (unsigned i = 0; i < e->variable_count; i++) {
+            if (e->mine[i]) {
+                e->mine_layouts[i]++;
+            }
+        }
+        return true;
+    }
+
+    for (int mine = 0; mine <= 1; mine++) {
+        if (mine && e->mines == e->mines_left) {
+            break;
+        }
+
+        bool fits = true;
+        for (unsigned l = 0; l < e->link_count[v]; l++) {
+            unsigned k = e->links[v][l];
+            e->assigned[k] += mine;
+            e->unassigned[k]--;
+            fits = fits && e->assigned[k] <= e->needed[k] &&
+                   e->assigned[k] + e->unassigned[k] >= e->needed[k];
+        }
+
+        bool within_budget = true;
+        if (fits) {
+            e->mine[v] = mine;
+            e->mines += (unsigned)mine;
+            within_budget = solver_backtrack(e, v + 1);
+            e->mines -= (unsigned)mine;
+        }
+
+        for (unsigned l = 0; l < e->link_count[v]; l++) {
+            unsigned k = e->links[v][l];
+            e->assigned[k] -= mine;
+            e->unassigned[k]++;
+        }
+
+        if (!within_budget) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Counts every layout of one component and settles the cells that are safe,
+// or mined, in all of them
+bool solver_enumerate_component(struct Solver *s, struct SolverEnum *e) {
+    e->constraint_count = 0;
+    for (unsigned v = 0; v < e->variable_count; v++) {
+        unsigned index = s->variables[v];
+        e->link_count[v] = 0;
+        e->mine[v] = false;
+        e->mine_layouts[v] = 0;
+
+        for (unsigned n = 0; n < 8; n++) {
+            unsigned next = index + s->neighbours[n];
+            if (s->known[next] != SOLVER_OPEN) {
+                continue;
+            }
+
+            // Numbers get their slot the first time one of their cells
+            // links to them
+            unsigned k = s->tag[next];
+            if (k == SOLVER_NO_TAG) {
+                k = e->constraint_count++;
+                s->tag[next] = k;
+
+                unsigned covered[8];
+                e->unassigned[k] =
+                    (int)solver_covered_around(s, next, covered, &e->needed[k]);
+                e->assigned[k] = 0;
+            }
+            e->links[v][e->link_count[v]++] = k;
+        }
+    }
+
+    e->layouts = 0;
+    e->steps = 0;
+    e->mines = 0;
+    e->mines_left = s->mines_left;
+    bool complete = solver_backtrack(e, 0);
+
+    // Clear the numbers' tags for the next component
+    for (unsigned v = 0; v < e->variable_count; v++) {
+        for (unsigned n = 0; n < 8; n++) {
+            unsigned next = s->variables[v] + s->neighbours[n];
+            if (s->known[next] == SOLVER_OPEN) {
+                s->tag[next] = SOLVER_NO_TAG;
+            }
+        }
+    }
+
+    if (!complete || e->layouts == 0) {
+        return false;
+    }
+
+    bool progress = false;
+    for (unsigned v = 0; v < e->variable_count; v++) {
+        if (e->mine_layouts[v] == 0) {
+            solver_push_safe(s, s->variables[v]);
+            progress = true;
+        } else if (e->mine_layouts[v] == e->layouts) {
+            solver_mark_mine(s, s->variables[v]);
+            progress = true;
+        }
+    }
+    solver_open_stack(s);
+
+    return progress;
+}
+
+// Splits the covered cells next to numbers into components linked by shared
+// numbers and enumerates each one small enough
+bool solver_enumerate(struct Solver *s) {
+    struct SolverEnum e;
+
+    for (size_t i = 0; i < (size_t)(s->rows + 2) * s->stride; i++) {
+        s->tag[i] = SOLVER_NO_TAG;
+    }
+
+    for (unsigned r = 1; r <= s->rows; r++) {
+        for (unsigned c = 1; c <= s->columns; c++) {
+            unsigned start = r * s->stride + c;
+            if (s->known[start] != SOLVER_COVERED ||
+                s->tag[start] != SOLVER_NO_TAG) {
+                continue;
+            }
+
+            // Breadth-first over cell -> number -> cell, tagging the cells
+            // seen so each component is walked once. Numbers are tagged in
+            // the constraint list only for the walk.
+            unsigned variable_count = 0;
+            unsigned constraint_count = 0;
+            s->tag[start] = 0;
+            s->variables[variable_count++] = start;
+            for (unsigned head = 0; head < variable_count; head++) {
+                unsigned cell = s->variables[head];
+                for (unsigned n = 0; n < 8; n++) {
+                    unsigned number = cell + s->neighbours[n];
+                    if (s->known[number] != SOLVER_OPEN ||
+                        s->tag[number] != SOLVER_NO_TAG) {
+                        continue;
+                    }
+                    s->tag[number] = 0;
+                    s->constraints[constraint_count++] = number;
+
+                    for (unsigned m = 0; m < 8; m++) {
+                        unsigned next = number + s->neighbours[m];
+                        if (s->known[next] == SOLVER_COVERED &&
+                            s->tag[next] == SOLVER_NO_TAG) {
+                            s->tag[next] = 0;
+                            s->variables[variable_count++] = next;
+                        }
+                    }
+                }
+            }
+            for (unsigned k = 0; k < constraint_count; k++) {
+                s->tag[s->constraints[k]] = SOLVER_NO_TAG;
+            }
+
+            // Covered cells with no open number around them are not part of
+            // the frontier
+            if (constraint_count == 0 ||
+                variable_count > SOLVER_ENUM_CELLS) {
+                continue;
+            }
+
+            // Cells opened here would carry stale tags into the next
+            // component, so the cheaper rules go first again
+            e.variable_count = variable_count;
+            if (solver_enumerate_component(s, &e)) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+bool solver_solve(struct Solver *s, const Uint8 *cells, unsigned start_index) {
+    s->cells = cells;
+    s->safe_left = 0;
+    s->mines_left = 0;
+    s->covered = s->rows * s->columns;
+    s->queue_count = 0;
+    s->stack_count = 0;
+    s->contradiction = false;
+
+    size_t cell_count = (size_t)(s->rows + 2) * s->stride;
+    for (size_t i = 0; i < cell_count; i++) {
+        s->known[i] = SOLVER_BORDER;
+        s->queued[i] = false;
+    }
+    for (unsigned r = 1; r <= s->rows; r++) {
+        for (unsigned c = 1; c <= s->columns; c++) {
+            unsigned index = r * s->stride + c;
+            s->known[index] = SOLVER_COVERED;
+            if (cells[index] & CELL_MINE) {
+                s->mines_left++;
+            } else {
+                s->safe_left++;
+            }
+        }
+    }
+
+    solver_push_safe(s, start_index);
+    solver_open_stack(s);
+
+    // Cheaper rules first; any progress goes back to the single-cell rules
+    while (!s->contradiction) {
+        solver_single_rules(s);
+        if (s->safe_left == 0 || s->contradiction) {
+            break;
+        }
+        if (!solver_global_rules(s) && !solver_pair_rules(s) &&
+            !solver_enumerate(s)) {
+            break;
+        }
+    }
+
+    return s->safe_left == 0 && !s->contradiction;
+}
@@ -0,0 +1,57 @@
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include "main.h"
+
+// Plays a board from its first click without guessing, to tell whether the
+// board can be cleared by logic alone. It reads the cells in the board
+// layout (see board.h) and uses, in order of cost:
+// - single-cell rules: a number whose mines are all found frees its other
+//   neighbours, one with as many covered neighbours as mines left marks them;
+// - the mine count: with no mines left every covered cell is safe, and with
+//   as many covered cells as mines left they are all mines;
+// - pair rules between numbers up to two cells apart, where the mines one
+//   still needs force the cells it does not share with the other;
+// - exhaustive enumeration of each connected frontier component of up to
+//   SOLVER_ENUM_CELLS cells, keeping cells that are safe or mined in every
+//   consistent layout.
+// The result depends only on the cells, so it is the same on every thread.
+
+#define SOLVER_ENUM_CELLS 24
+#define SOLVER_ENUM_STEPS 200000
+
+enum SolverCell {
+    SOLVER_COVERED = 0,
+    SOLVER_OPEN,
+    SOLVER_MINE,                // Proven to be a mine
+    SOLVER_SAFE,                // Proven safe, waiting on the stack
+    SOLVER_BORDER               // Ghost cell around the board
+};
+
+struct Solver {
+        unsigned rows;
+        unsigned columns;
+        unsigned stride;
+        unsigned neighbours[8];     // Index offsets of the 8 neighbours
+        const Uint8 *cells;         // Board being solved
+        Uint8 *known;               // SolverCell per cell
+        unsigned *queue;            // Open numbers whose neighbours changed
+        unsigned queue_count;
+        bool *queued;
+        unsigned *stack;            // Cells waiting to be opened
+        unsigned stack_count;
+        unsigned *tag;              // Component scratch: variable or constraint
+        unsigned *variables;        // Covered frontier cells of a component
+        unsigned *constraints;      // Open numbers around a component
+        unsigned safe_left;
+        unsigned mines_left;
+        unsigned covered;
+        bool contradiction;         // A deduction hit a mine: a solver bug
+};
+
+bool solver_new(struct Solver **solver, unsigned rows, unsigned columns);
+void solver_free(struct Solver **solver);
+// True when every safe cell can be uncovered from start_index without a guess
+bool solver_solve(struct Solver *s, const Uint8 *cells, unsigned start_index);
+
+#endif
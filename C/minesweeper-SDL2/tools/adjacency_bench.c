@@ -0,0 +1,183 @@
+// Times the adjacency counts done once mines are placed. "nested loop" is the
+// old board_reset pass: a 3x3 loop per cell over an array of unsigned rows,
+// bounds-checking every neighbour. "scalar" and the vector kernel run over the
+// current byte cells with a ghost border. Every kernel's counts are checked
+// against the nested loop.
+// Usage: adjacency_bench [density] [seconds per case]
+#define _POSIX_C_SOURCE 200809L
+
+#include "../src/adjacency.h"
+#include "../src/board.h"
+#include <time.h>
+
+#define OLD_MINE 13
+
+struct Case {
+        unsigned rows;
+        unsigned columns;
+};
+
+static const struct Case cases[] = {
+    {9, 9}, {16, 30}, {40, 80}, {100, 100}, {1000, 1000}, {4000, 4000},
+};
+
+static double now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e6 + (double)ts.tv_nsec / 1e3;
+}
+
+// The count pass board_reset used before the byte cells
+static void nested_loop_count(unsigned **back_array, unsigned rows,
+                              unsigned columns) {
+    for (int row = 0; row < (int)rows; row++) {
+        for (int column = 0; column < (int)columns; column++) {
+            unsigned close_mines = 0;
+            if (back_array[row][column] == OLD_MINE) {
+                continue;
+            }
+            for (int r = row - 1; r < row + 2; r++) {
+                if (r >= 0 && r < (int)rows) {
+                    for (int c = column - 1; c < column + 2; c++) {
+                        if (c >= 0 && c < (int)columns) {
+                            if (back_array[r][c] == OLD_MINE) {
+                                close_mines++;
+                            }
+                        }
+                    }
+                }
+            }
+            back_array[row][column] = close_mines;
+        }
+    }
+}
+
+typedef void (*CountFn)(Uint8 *cells, unsigned rows, unsigned columns,
+                        unsigned stride);
+
+// Runs fn until the time budget is spent and returns microseconds per run
+static double time_cells(CountFn fn, Uint8 *cells, unsigned rows,
+                         unsigned columns, unsigned stride, double budget_us) {
+    unsigned runs = 0;
+    double start = now_us();
+    double elapsed;
+    do {
+        fn(cells, rows, columns, stride);
+        runs++;
+        elapsed = now_us() - start;
+    } while (elapsed < budget_us);
+    return elapsed / runs;
+}
+
+static bool counts_match(unsigned **back_array, const Uint8 *cells,
+                         unsigned rows, unsigned columns, unsigned stride) {
+    for (unsigned r = 0; r < rows; r++) {
+        for (unsigned c = 0; c < columns; c++) {
+            Uint8 cell = cells[(r + 1) * stride + c + 1];
+            if (back_array[r][c] == OLD_MINE) {
+                if (!(cell & CELL_MINE)) {
+                    return false;
+                }
+            } else if ((cell & CELL_COUNT_MASK) != back_array[r][c]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static bool run_case(struct Case cs, double density, double budget_us) {
+    bool ok = false;
+    unsigned rows = cs.rows;
+    unsigned columns = cs.columns;
+    unsigned stride = columns + 2;
+
+    unsigned **back_array = calloc(rows, sizeof(unsigned *));
+    Uint8 *cells = calloc((size_t)(rows + 2) * stride, sizeof(Uint8));
+    if (!back_array || !cells) {
+        fprintf(stderr, "Error in calloc of benchmark board!\n");
+        goto cleanup;
+    }
+    for (unsigned r = 0; r < rows; r++) {
+        back_array[r] = calloc(columns, sizeof(unsigned));
+        if (!back_array[r]) {
+            fprintf(stderr, "Error in calloc of benchmark board!\n");
+            goto cleanup;
+        }
+    }
+
+    // Covered cells with a random mine layout in both representations
+    for (unsigned r = 0; r < rows; r++) {
+        for (unsigned c = 0; c < columns; c++) {
+            Uint8 *cell = &cells[(r + 1) * stride + c + 1];
+            *cell = (Uint8)(CELL_COVERED << CELL_STATE_SHIFT);
+            if ((double)rand() / RAND_MAX < density) {
+                back_array[r][c] = OLD_MINE;
+                *cell |= CELL_MINE;
+            }
+        }
+    }
+
+    unsigned runs = 0;
+    double start = now_us();
+    double elapsed;
+    do {
+        nested_loop_count(back_array, rows, columns);
+        runs++;
+        elapsed = now_us() - start;
+    } while (elapsed < budget_us);
+    double nested_us = elapsed / runs;
+
+    double scalar_us = time_cells(adjacency_count_scalar, cells, rows, columns,
+                                  stride, budget_us);
+    if (!counts_match(back_array, cells, rows, columns, stride)) {
+        fprintf(stderr, "%ux%u: scalar counts differ!\n", rows, columns);
+        goto cleanup;
+    }
+
+    // Clear the counts so the vector kernel has to write them itself
+    for (size_t i = 0; i < (size_t)(rows + 2) * stride; i++) {
+        cells[i] &= (Uint8)~CELL_COUNT_MASK;
+    }
+    double vector_us =
+        time_cells(adjacency_count, cells, rows, columns, stride, budget_us);
+    if (!counts_match(back_array, cells, rows, columns, stride)) {
+        fprintf(stderr, "%ux%u: %s counts differ!\n", rows, columns,
+                adjacency_kernel_name());
+        goto cleanup;
+    }
+
+    printf("%4ux%-4u  %12.2f  %12.2f  %12.2f  %6.1fx\n", rows, columns,
+           nested_us, scalar_us, vector_us, nested_us / vector_us);
+    ok = true;
+
+cleanup:
+    if (back_array) {
+        for (unsigned r = 0; r < rows; r++) {
+            free(back_array[r]);
+        }
+        free(back_array);
+    }
+    free(cells);
+    return ok;
+}
+
+int main(int argc, char *argv[]) {
+    double density = argc > 1 ? atof(argv[1]) : 0.2;
+    double seconds = argc > 2 ? atof(argv[2]) : 0.25;
+
+    srand(1);
+
+    printf("density %.2f, vector kernel %s, microseconds per board\n", density,
+           adjacency_kernel_name());
+    printf("%-9s  %12s  %12s  %12s  %7s\n", "board", "nested loop", "scalar",
+           adjacency_kernel_name(), "speedup");
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        if (!run_case(cases[i], density, seconds * 1e6)) {
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}